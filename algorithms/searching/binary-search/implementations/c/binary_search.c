@@ -8,34 +8,95 @@
 #include <stdlib.h>
 #include <string.h>
 
+/**
+ * Branchless lower bound: index of the first element not less than target.
+ * The remaining length halves every step and the base moves by a
+ * conditional move, so the loop has no data-dependent branch and runs
+ * exactly ceil(log2(size)) iterations.
+ * 无分支下界：返回第一个不小于目标值的元素下标
+ */
+static size_t lower_bound_branchless(const int* arr, size_t size, int target) {
+    if (size == 0) {
+        return 0;
+    }
+
+    const int* base = arr;
+    size_t length = size;
+
+    while (length > 1) {
+        size_t half = length / 2;
+        base = (base[half] < target) ? base + half : base;
+        length -= half;
+    }
+
+    return (size_t)(base - arr) + (*base < target);
+}
+
+/**
+ * Branchless upper bound: index of the first element greater than target.
+ * 无分支上界：返回第一个大于目标值的元素下标
+ */
+static size_t upper_bound_branchless(const int* arr, size_t size, int target) {
+    if (size == 0) {
+        return 0;
+    }
+
+    const int* base = arr;
+    size_t length = size;
+
+    while (length > 1) {
+        size_t half = length / 2;
+        base = (base[half] <= target) ? base + half : base;
+        length -= half;
+    }
+
+    return (size_t)(base - arr) + (*base <= target);
+}
+
+/**
+ * Fused bounds: first = lower bound of lo, end = upper bound of hi (lo <= hi).
+ * Both branchless searches share one loop and halving schedule; until their
+ * paths split they probe the same element, so the common upper levels are
+ * fetched once, and afterwards their two probes overlap.
+ * 融合边界查找：两次无分支查找共用一个循环，路径分开前访问相同元素
+ */
+static void fused_bounds(const int* arr, size_t size, int lo, int hi, size_t* first, size_t* end) {
+    if (size == 0) {
+        *first = 0;
+        *end = 0;
+        return;
+    }
+
+    const int* lower = arr;
+    const int* upper = arr;
+    size_t length = size;
+
+    while (length > 1) {
+        size_t half = length / 2;
+        lower = (lower[half] < lo) ? lower + half : lower;
+        upper = (upper[half] <= hi) ? upper + half : upper;
+        length -= half;
+    }
+
+    *first = (size_t)(lower - arr) + (*lower < lo);
+    *end = (size_t)(upper - arr) + (*upper <= hi);
+}
+
 /**
  * Performs binary search on a sorted integer array (iterative approach)
  * 在已排序的整数数组上执行二分查找（迭代方法）
  */
 BinarySearchResult binary_search(const int* arr, size_t size, int target) {
-    BinarySearchResult result = {-1, false};
+    BinarySearchResult result = {BINARY_SEARCH_NOT_FOUND, false};
 
     if (arr == NULL || size == 0) {
         return result;
     }
 
-    size_t left = 0;
-    size_t right = size - 1;
-
-    while (left <= right) {
-        // Use left + (right - left) / 2 to avoid potential overflow
-        size_t mid = left + (right - left) / 2;
-
-        if (arr[mid] == target) {
-            result.index = (int)mid;
-            result.found = true;
-            return result;
-        } else if (arr[mid] < target) {
-            left = mid + 1;
-        } else {
-            if (mid == 0) break;  // Prevent underflow
-            right = mid - 1;
-        }
+    size_t index = lower_bound_branchless(arr, size, target);
+    if (index < size && arr[index] == target) {
+        result.index = (ptrdiff_t)index;
+        result.found = true;
     }
 
     return result;
@@ -46,7 +107,7 @@ BinarySearchResult binary_search(const int* arr, size_t size, int target) {
  * 递归二分查找的辅助函数
  */
 static BinarySearchResult binary_search_recursive_helper(const int* arr, size_t left, size_t right, int target) {
-    BinarySearchResult result = {-1, false};
+    BinarySearchResult result = {BINARY_SEARCH_NOT_FOUND, false};
 
     if (left > right) {
         return result;
@@ -55,7 +116,7 @@ static BinarySearchResult binary_search_recursive_helper(const int* arr, size_t
     size_t mid = left + (right - left) / 2;
 
     if (arr[mid] == target) {
-        result.index = (int)mid;
+        result.index = (ptrdiff_t)mid;
         result.found = true;
         return result;
     } else if (arr[mid] < target) {
@@ -71,7 +132,7 @@ static BinarySearchResult binary_search_recursive_helper(const int* arr, size_t
  * 在已排序的整数数组上执行二分查找（递归方法）
  */
 BinarySearchResult binary_search_recursive(const int* arr, size_t size, int target) {
-    BinarySearchResult result = {-1, false};
+    BinarySearchResult result = {BINARY_SEARCH_NOT_FOUND, false};
 
     if (arr == NULL || size == 0) {
         return result;
@@ -85,7 +146,7 @@ BinarySearchResult binary_search_recursive(const int* arr, size_t size, int targ
  * 执行带详细步骤输出的二分查找
  */
 BinarySearchVerboseResult binary_search_verbose(const int* arr, size_t size, int target) {
-    BinarySearchVerboseResult result = {-1, 0, false};
+    BinarySearchVerboseResult result = {BINARY_SEARCH_NOT_FOUND, 0, false};
 
     if (arr == NULL || size == 0) {
         printf("Empty array provided\n");
@@ -113,7 +174,7 @@ BinarySearchVerboseResult binary_search_verbose(const int* arr, size_t size, int
 
         if (arr[mid] == target) {
             printf("  Target found at index %zu!\n", mid);
-            result.index = (int)mid;
+            result.index = (ptrdiff_t)mid;
             result.found = true;
             return result;
         } else if (arr[mid] < target) {
@@ -135,116 +196,499 @@ BinarySearchVerboseResult binary_search_verbose(const int* arr, size_t size, int
  * 在包含重复元素的已排序数组中查找目标值的第一次出现
  */
 BinarySearchResult binary_search_first_occurrence(const int* arr, size_t size, int target) {
-    BinarySearchResult result = {-1, false};
+    // The first occurrence is the lower bound, if it holds target
+    return binary_search(arr, size, target);
+}
+
+/**
+ * Find the last occurrence of target in a sorted array with duplicates
+ * 在包含重复元素的已排序数组中查找目标值的最后一次出现
+ */
+BinarySearchResult binary_search_last_occurrence(const int* arr, size_t size, int target) {
+    BinarySearchResult result = {BINARY_SEARCH_NOT_FOUND, false};
 
     if (arr == NULL || size == 0) {
         return result;
     }
 
-    size_t left = 0;
-    size_t right = size - 1;
-    int first_index = -1;
+    // The last occurrence is just before the upper bound
+    size_t end = upper_bound_branchless(arr, size, target);
+    if (end > 0 && arr[end - 1] == target) {
+        result.index = (ptrdiff_t)(end - 1);
+        result.found = true;
+    }
 
-    while (left <= right) {
-        size_t mid = left + (right - left) / 2;
+    return result;
+}
 
-        if (arr[mid] == target) {
-            first_index = (int)mid;
-            result.found = true;
-            // Continue searching in left half for first occurrence
-            if (mid == 0) break;  // Prevent underflow
-            right = mid - 1;
-        } else if (arr[mid] < target) {
-            left = mid + 1;
-        } else {
-            if (mid == 0) break;  // Prevent underflow
-            right = mid - 1;
-        }
+/**
+ * Find the range [first_index, last_index] of target in sorted array
+ * 在已排序数组中查找目标值的所有出现位置范围
+ */
+BinarySearchRangeResult binary_search_range(const int* arr, size_t size, int target) {
+    BinarySearchRangeResult result = {BINARY_SEARCH_NOT_FOUND, BINARY_SEARCH_NOT_FOUND, false};
+
+    if (arr == NULL || size == 0) {
+        return result;
+    }
+
+    size_t first;
+    size_t end;
+    fused_bounds(arr, size, target, target, &first, &end);
+    if (first < end) {
+        result.first_index = (ptrdiff_t)first;
+        result.last_index = (ptrdiff_t)(end - 1);
+        result.found = true;
     }
 
-    result.index = first_index;
     return result;
 }
 
 /**
- * Find the last occurrence of target in a sorted array with duplicates
- * 在包含重复元素的已排序数组中查找目标值的最后一次出现
+ * Count the elements within [lo, hi] in a sorted array
+ * 统计已排序数组中位于 [lo, hi] 内的元素个数
  */
-BinarySearchResult binary_search_last_occurrence(const int* arr, size_t size, int target) {
-    BinarySearchResult result = {-1, false};
+size_t binary_search_count_range(const int* arr, size_t size, int lo, int hi) {
+    if (arr == NULL || lo > hi) {
+        return 0;
+    }
+
+    size_t first;
+    size_t end;
+    fused_bounds(arr, size, lo, hi, &first, &end);
+    return end - first;
+}
+
+/**
+ * Find the insertion point for target to maintain sorted order
+ * 查找目标值的插入位置以保持数组排序
+ */
+size_t binary_search_insertion_point(const int* arr, size_t size, int target) {
+    if (arr == NULL) {
+        return 0;
+    }
+
+    return lower_bound_branchless(arr, size, target);
+}
+
+/**
+ * Galloping lower bound: bracket the answer with probes at distances
+ * 1, 2, 4, ... from the hint, then search the bracket
+ * 倍增下界：从提示位置按指数距离探测以确定区间，再在区间内查找
+ */
+static size_t gallop_lower_bound(const int* arr, size_t size, int target, size_t hint) {
+    size_t lo;
+    size_t hi;
+
+    if (hint > size) {
+        hint = size;
+    }
+
+    if (hint < size && arr[hint] < target) {
+        // The answer is after the hint: gallop right
+        lo = hint + 1;
+        hi = size;
+        for (size_t step = 1; step < size - hint; step *= 2) {
+            if (!(arr[hint + step] < target)) {
+                hi = hint + step;
+                break;
+            }
+            lo = hint + step + 1;
+        }
+    } else {
+        // The answer is at or before the hint: gallop left
+        lo = 0;
+        hi = hint;
+        for (size_t step = 1; step <= hint; step *= 2) {
+            if (arr[hint - step] < target) {
+                lo = hint - step + 1;
+                break;
+            }
+            hi = hint - step;
+        }
+    }
+
+    return lo + lower_bound_branchless(arr + lo, hi - lo, target);
+}
+
+/**
+ * Galloping (exponential) search starting from a hint position
+ * 从提示位置开始的倍增（galloping）查找
+ */
+BinarySearchResult binary_search_from_hint(const int* arr, size_t size, int target, size_t hint) {
+    BinarySearchResult result = {BINARY_SEARCH_NOT_FOUND, false};
 
     if (arr == NULL || size == 0) {
         return result;
     }
 
-    size_t left = 0;
-    size_t right = size - 1;
-    int last_index = -1;
+    size_t index = gallop_lower_bound(arr, size, target, hint);
+    if (index < size && arr[index] == target) {
+        result.index = (ptrdiff_t)index;
+        result.found = true;
+    }
 
-    while (left <= right) {
-        size_t mid = left + (right - left) / 2;
+    return result;
+}
 
-        if (arr[mid] == target) {
-            last_index = (int)mid;
-            result.found = true;
-            // Continue searching in right half for last occurrence
-            left = mid + 1;
-        } else if (arr[mid] < target) {
-            left = mid + 1;
+/**
+ * Initialize a search cursor at the start of a sorted array
+ * 在已排序数组起始处初始化查找游标
+ */
+void binary_search_cursor_init(BinarySearchCursor* cursor, const int* arr, size_t size) {
+    if (cursor == NULL) {
+        return;
+    }
+
+    cursor->arr = arr;
+    cursor->size = arr == NULL ? 0 : size;
+    cursor->position = 0;
+}
+
+/**
+ * Search with a cursor, galloping from where the previous lookup ended
+ * 使用游标查找，从上次查找结束的位置开始倍增探测
+ */
+BinarySearchResult binary_search_cursor_find(BinarySearchCursor* cursor, int target) {
+    BinarySearchResult result = {BINARY_SEARCH_NOT_FOUND, false};
+
+    if (cursor == NULL || cursor->size == 0) {
+        return result;
+    }
+
+    cursor->position = gallop_lower_bound(cursor->arr, cursor->size, target, cursor->position);
+    if (cursor->position < cursor->size && cursor->arr[cursor->position] == target) {
+        result.index = (ptrdiff_t)cursor->position;
+        result.found = true;
+    }
+
+    return result;
+}
+
+/**
+ * Convert an estimated position to a probe inside [lo, hi)
+ * 将估计位置限制在 [lo, hi) 内
+ */
+static size_t clamp_probe(double position, size_t lo, size_t hi) {
+    if (!(position >= (double)lo)) {
+        return lo;  // Also catches NaN from degenerate ranges
+    }
+    if (position >= (double)(hi - 1)) {
+        return hi - 1;
+    }
+    return (size_t)position;
+}
+
+/**
+ * Estimate the position of target by linear interpolation between the range ends
+ * 在区间两端之间线性插值估计目标位置
+ */
+static size_t interpolation_probe(const int* arr, size_t lo, size_t hi, int target) {
+    double first = arr[lo];
+    double last = arr[hi - 1];
+    if (!(last > first)) {
+        return lo;
+    }
+    double position = lo + (target - first) * (double)(hi - 1 - lo) / (last - first);
+    return clamp_probe(position, lo, hi);
+}
+
+/**
+ * Estimate the position of target by inverse quadratic interpolation
+ * through the range ends and its middle
+ * 通过区间两端和中点做逆二次插值估计目标位置
+ */
+static size_t three_point_probe(const int* arr, size_t lo, size_t hi, int target) {
+    size_t mid = lo + (hi - lo) / 2;
+    double x0 = arr[lo];
+    double x1 = arr[mid];
+    double x2 = arr[hi - 1];
+    if (!(x0 < x1 && x1 < x2)) {
+        return interpolation_probe(arr, lo, hi, target);
+    }
+
+    double t = target;
+    double position = lo * (t - x1) * (t - x2) / ((x0 - x1) * (x0 - x2))
+                      + mid * (t - x0) * (t - x2) / ((x1 - x0) * (x1 - x2))
+                      + (hi - 1) * (t - x0) * (t - x1) / ((x2 - x0) * (x2 - x1));
+    return clamp_probe(position, lo, hi);
+}
+
+/**
+ * Narrow [lo, hi] around the lower bound with one comparison at position
+ * 用一次比较收缩下界所在区间
+ */
+static void narrow(const int* arr, size_t position, int target, size_t* lo, size_t* hi) {
+    if (arr[position] < target) {
+        *lo = position + 1;
+    } else {
+        *hi = position;
+    }
+}
+
+/**
+ * Integer square root: the largest root with root * root <= value
+ * 整数平方根：满足 root * root <= value 的最大 root
+ */
+static size_t integer_sqrt(size_t value) {
+    size_t root = 0;
+    size_t bit = (size_t)1 << (sizeof(size_t) * 8 - 2);
+
+    while (bit > value) {
+        bit >>= 2;
+    }
+    while (bit != 0) {
+        if (value >= root + bit) {
+            value -= root + bit;
+            root = (root >> 1) + bit;
         } else {
-            if (mid == 0) break;  // Prevent underflow
-            right = mid - 1;
+            root >>= 1;
         }
+        bit >>= 2;
     }
+    return root;
+}
 
-    result.index = last_index;
-    return result;
+/**
+ * Lower bound in arr[lo, hi), given the answer lies in [lo, hi]. Each
+ * probe is followed by a fence floor(sqrt(range)) towards the target (the
+ * typical estimate error on uniform keys, and the same gap as the C++
+ * guardedLowerBound), and by a binary step whenever the range still did
+ * not halve.
+ * 每次探测后在 floor(sqrt(区间)) 处设置栅栏；若区间仍未减半则追加二分步骤
+ */
+static size_t guarded_lower_bound(const int* arr, size_t lo, size_t hi, int target,
+                                  size_t (*probe)(const int*, size_t, size_t, int)) {
+    while (hi - lo > 16) {
+        size_t before = hi - lo;
+        size_t gap = integer_sqrt(before);
+
+        size_t position = probe(arr, lo, hi, target);
+        if (arr[position] < target) {
+            lo = position + 1;
+            narrow(arr, position + gap < hi - 1 ? position + gap : hi - 1, target, &lo, &hi);
+        } else {
+            hi = position;
+            if (position >= lo + gap) {
+                narrow(arr, position - gap, target, &lo, &hi);
+            }
+        }
+
+        if (hi - lo > before / 2) {
+            narrow(arr, lo + (hi - lo) / 2, target, &lo, &hi);
+        }
+    }
+    return lo + lower_bound_branchless(arr + lo, hi - lo, target);
 }
 
 /**
- * Find the range [first_index, last_index] of target in sorted array
- * 在已排序数组中查找目标值的所有出现位置范围
+ * Interpolation-sequential lower bound: one interpolation probe, then a
+ * short linear scan; long scans hand over to guarded interpolation
+ * 插值-顺序查找：一次插值探测后线性扫描，扫描过长时改用带保护的插值查找
  */
-BinarySearchRangeResult binary_search_range(const int* arr, size_t size, int target) {
-    BinarySearchRangeResult result = {-1, -1, false};
+static size_t interpolation_sequential_lower_bound(const int* arr, size_t size, int target) {
+    const size_t max_scan = 32;
+    size_t position = interpolation_probe(arr, 0, size, target);
+    size_t i;
+
+    if (arr[position] < target) {
+        i = position + 1;
+        for (size_t steps = 0; steps < max_scan; steps++, i++) {
+            if (i == size || !(arr[i] < target)) {
+                return i;
+            }
+        }
+        return guarded_lower_bound(arr, i, size, target, interpolation_probe);
+    }
 
-    BinarySearchResult first = binary_search_first_occurrence(arr, size, target);
-    if (!first.found) {
+    i = position;
+    for (size_t steps = 0; steps < max_scan; steps++, i--) {
+        if (i == 0 || arr[i - 1] < target) {
+            return i;
+        }
+    }
+    return guarded_lower_bound(arr, 0, i, target, interpolation_probe);
+}
+
+/**
+ * Search a sorted array using an interpolation-style probe strategy
+ * 使用插值类探测策略在已排序数组中查找
+ */
+BinarySearchResult binary_search_interpolation(const int* arr, size_t size, int target,
+                                               BinarySearchMode mode) {
+    BinarySearchResult result = {BINARY_SEARCH_NOT_FOUND, false};
+
+    if (arr == NULL || size == 0) {
         return result;
     }
 
-    BinarySearchResult last = binary_search_last_occurrence(arr, size, target);
+    size_t index;
+    switch (mode) {
+        case BINARY_SEARCH_MODE_INTERPOLATION:
+            index = guarded_lower_bound(arr, 0, size, target, interpolation_probe);
+            break;
+        case BINARY_SEARCH_MODE_INTERPOLATION_SEQUENTIAL:
+            index = interpolation_sequential_lower_bound(arr, size, target);
+            break;
+        case BINARY_SEARCH_MODE_THREE_POINT:
+            index = guarded_lower_bound(arr, 0, size, target, three_point_probe);
+            break;
+        default:
+            index = lower_bound_branchless(arr, size, target);
+            break;
+    }
 
-    result.first_index = first.index;
-    result.last_index = last.index;
-    result.found = true;
+    if (index < size && arr[index] == target) {
+        result.index = (ptrdiff_t)index;
+        result.found = true;
+    }
 
     return result;
 }
 
 /**
- * Find the insertion point for target to maintain sorted order
- * 查找目标值的插入位置以保持数组排序
+ * Choose a probe strategy by sampling the key distribution once: each
+ * sampled key is located with one linear and one three-point estimate,
+ * and the mean distance from its real position decides
+ * 采样若干键，比较线性与三点估计的平均误差来选择策略
  */
-size_t binary_search_insertion_point(const int* arr, size_t size, int target) {
-    if (arr == NULL) {
-        return 0;
+BinarySearchMode binary_search_select_mode(const int* arr, size_t size) {
+    const size_t samples = 64;
+    double linear_error = 0;
+    double three_point_error = 0;
+
+    if (arr == NULL || size < 2 * samples) {
+        return BINARY_SEARCH_MODE_BINARY;
     }
 
-    size_t left = 0;
-    size_t right = size;
+    for (size_t s = 1; s < samples; s++) {
+        size_t position = s * (size - 1) / samples;
+        double linear = (double)interpolation_probe(arr, 0, size, arr[position]) - (double)position;
+        double three_point = (double)three_point_probe(arr, 0, size, arr[position]) - (double)position;
+        linear_error += (linear < 0 ? -linear : linear) / (samples - 1);
+        three_point_error += (three_point < 0 ? -three_point : three_point) / (samples - 1);
+    }
 
-    while (left < right) {
-        size_t mid = left + (right - left) / 2;
+    // Estimates that still leave a large fraction of the array gain nothing
+    double best = linear_error < three_point_error ? linear_error : three_point_error;
+    if (best > (double)size / 32) {
+        return BINARY_SEARCH_MODE_BINARY;
+    }
+    // Close enough that a short scan from the first estimate usually finishes
+    if (linear_error <= 32) {
+        return BINARY_SEARCH_MODE_INTERPOLATION_SEQUENTIAL;
+    }
+    return three_point_error < linear_error / 2 ? BINARY_SEARCH_MODE_THREE_POINT
+                                                : BINARY_SEARCH_MODE_INTERPOLATION;
+}
 
-        if (arr[mid] < target) {
-            left = mid + 1;
-        } else {
-            right = mid;
+/**
+ * splitmix64 finalizer, used to hash keys for the filter
+ * splitmix64 混合函数，用于为过滤器计算键的哈希值
+ */
+static uint64_t filter_hash(int key) {
+    uint64_t x = (uint64_t)(uint32_t)key + 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+/**
+ * The 8-word block of a hash: the high 32 bits are mapped onto the block count
+ * 哈希值对应的块：将高 32 位映射到块的数量范围内
+ */
+static uint64_t* filter_block(const BinarySearchFilter* filter, uint64_t hash) {
+    return filter->blocks + ((hash >> 32) * filter->block_count >> 32) * 8;
+}
+
+/**
+ * Build a blocked Bloom filter over a sorted array
+ * 在已排序数组上建立分块布隆过滤器
+ */
+bool binary_search_filter_init(BinarySearchFilter* filter, const int* arr, size_t size,
+                               double false_positive_rate) {
+    if (filter == NULL) {
+        return false;
+    }
+
+    memset(filter, 0, sizeof(*filter));
+    filter->arr = arr;
+    filter->size = arr == NULL ? 0 : size;
+
+    // k = log2(1 / rate) bits per key in k / ln 2 bits of space per key,
+    // plus 5% per hash for uneven loads across blocks
+    filter->hashes = 1;
+    for (double rate = 0.5; rate > false_positive_rate && filter->hashes < 16; rate /= 2) {
+        filter->hashes++;
+    }
+    double bits_per_key = (1 + 0.05 * filter->hashes) * filter->hashes / 0.6931471805599453;
+    filter->block_count = (size_t)((double)filter->size * bits_per_key / 512) + 1;
+
+    // Over-allocate to align the blocks to cache lines
+    filter->storage = calloc(filter->block_count * 8 + 8, sizeof(uint64_t));
+    if (filter->storage == NULL) {
+        return false;
+    }
+    filter->blocks = (uint64_t*)(((uintptr_t)filter->storage + 63) & ~(uintptr_t)63);
+
+    for (size_t i = 0; i < filter->size; i++) {
+        uint64_t hash = filter_hash(arr[i]);
+        uint64_t* block = filter_block(filter, hash);
+        uint32_t position = (uint32_t)hash;
+        uint32_t step = (uint32_t)(hash >> 9) | 1;
+        for (unsigned j = 0; j < filter->hashes; j++, position += step) {
+            block[(position >> 6) & 7] |= (uint64_t)1 << (position & 63);
         }
     }
 
-    return left;
+    return true;
+}
+
+/**
+ * Search through the filter and update its counters
+ * 通过过滤器查找并更新计数器
+ */
+BinarySearchResult binary_search_filtered(BinarySearchFilter* filter, int target) {
+    BinarySearchResult result = {BINARY_SEARCH_NOT_FOUND, false};
+
+    if (filter == NULL || filter->blocks == NULL) {
+        return result;
+    }
+
+    uint64_t hash = filter_hash(target);
+    const uint64_t* block = filter_block(filter, hash);
+    uint32_t position = (uint32_t)hash;
+    uint32_t step = (uint32_t)(hash >> 9) | 1;
+    uint64_t missing = 0;
+    for (unsigned j = 0; j < filter->hashes; j++, position += step) {
+        missing |= ~block[(position >> 6) & 7] & ((uint64_t)1 << (position & 63));
+    }
+    if (missing != 0) {
+        filter->definite_misses++;
+        return result;
+    }
+
+    result = binary_search(filter->arr, filter->size, target);
+    if (result.found) {
+        filter->hits++;
+    } else {
+        filter->false_positives++;
+    }
+
+    return result;
+}
+
+/**
+ * Free the memory of a filter
+ * 释放过滤器的内存
+ */
+void binary_search_filter_free(BinarySearchFilter* filter) {
+    if (filter == NULL) {
+        return;
+    }
+
+    free(filter->storage);
+    memset(filter, 0, sizeof(*filter));
 }
 
 /**
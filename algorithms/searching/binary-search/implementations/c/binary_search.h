@@ -11,18 +11,26 @@
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/**
+ * Index reported when the target is not found. Indices are ptrdiff_t so
+ * arrays beyond 2^31 elements (e.g. memory-mapped key files) are covered.
+ * 未找到目标时返回的索引；索引类型为 ptrdiff_t，支持超过 2^31 个元素的数组
+ */
+#define BINARY_SEARCH_NOT_FOUND ((ptrdiff_t)-1)
+
 /**
  * Binary search result structure
  * 二分查找结果结构体
  */
 typedef struct {
-    int index;      // Index of found element, -1 if not found
-    bool found;     // Whether the element was found
+    ptrdiff_t index;    // Index of found element, BINARY_SEARCH_NOT_FOUND if not found
+    bool found;         // Whether the element was found
 } BinarySearchResult;
 
 /**
@@ -30,9 +38,9 @@ typedef struct {
  * 二分查找范围结果结构体
  */
 typedef struct {
-    int first_index;    // Index of first occurrence, -1 if not found
-    int last_index;     // Index of last occurrence, -1 if not found
-    bool found;         // Whether the element was found
+    ptrdiff_t first_index;  // Index of first occurrence, BINARY_SEARCH_NOT_FOUND if not found
+    ptrdiff_t last_index;   // Index of last occurrence, BINARY_SEARCH_NOT_FOUND if not found
+    bool found;             // Whether the element was found
 } BinarySearchRangeResult;
 
 /**
@@ -40,11 +48,48 @@ typedef struct {
  * 带详细输出的二分查找结果
  */
 typedef struct {
-    int index;      // Index of found element, -1 if not found
-    int steps;      // Number of steps taken
-    bool found;     // Whether the element was found
+    ptrdiff_t index;    // Index of found element, BINARY_SEARCH_NOT_FOUND if not found
+    int steps;          // Number of steps taken
+    bool found;         // Whether the element was found
 } BinarySearchVerboseResult;
 
+/**
+ * Search cursor remembering where the last lookup ended
+ * 记录上次查找结束位置的查找游标
+ */
+typedef struct {
+    const int* arr;     // Sorted array being searched (not owned)
+    size_t size;        // Size of the array
+    size_t position;    // Lower bound found by the last lookup
+} BinarySearchCursor;
+
+/**
+ * Sorted array fronted by a blocked Bloom filter, with lookup counters
+ * 带分块布隆过滤器的已排序数组及查找计数器
+ */
+typedef struct {
+    const int* arr;             // Sorted array being searched (not owned)
+    size_t size;                // Size of the array
+    void* storage;              // Allocation holding the blocks
+    uint64_t* blocks;           // 64-byte blocks of 8 words, cache-line aligned
+    size_t block_count;         // Number of blocks
+    unsigned hashes;            // Bits set per key
+    size_t hits;                // Lookups of present keys
+    size_t definite_misses;     // Absent keys rejected by the filter alone
+    size_t false_positives;     // Absent keys that passed the filter and needed a search
+} BinarySearchFilter;
+
+/**
+ * Probe strategies for interpolation-style searches
+ * 插值类查找的探测策略
+ */
+typedef enum {
+    BINARY_SEARCH_MODE_BINARY,                    // Plain halving
+    BINARY_SEARCH_MODE_INTERPOLATION,             // Linear interpolation between range ends
+    BINARY_SEARCH_MODE_INTERPOLATION_SEQUENTIAL,  // One interpolation probe, then a linear scan
+    BINARY_SEARCH_MODE_THREE_POINT                // Inverse quadratic interpolation (ends + middle)
+} BinarySearchMode;
+
 /**
  * Performs binary search on a sorted integer array (iterative approach)
  * 在已排序的整数数组上执行二分查找（迭代方法）
@@ -104,6 +149,10 @@ BinarySearchResult binary_search_last_occurrence(const int* arr, size_t size, in
  * Find the range [first_index, last_index] of target in sorted array
  * 在已排序数组中查找目标值的所有出现位置范围
  *
+ * One fused search: both ends are found in the same loop and share their
+ * probes until the paths split.
+ * 融合查找：两端在同一循环中查找，路径分开前共享探测
+ *
  * @param arr Pointer to sorted integer array
  * @param size Size of the array
  * @param target Target value to search for
@@ -111,6 +160,22 @@ BinarySearchResult binary_search_last_occurrence(const int* arr, size_t size, in
  */
 BinarySearchRangeResult binary_search_range(const int* arr, size_t size, int target);
 
+/**
+ * Count the elements within [lo, hi] in a sorted array
+ * 统计已排序数组中位于 [lo, hi] 内的元素个数
+ *
+ * Like binary_search_range, the searches for both ends share their probes
+ * until the paths split.
+ * 与 binary_search_range 相同，两端的查找在路径分开前共享探测
+ *
+ * @param arr Pointer to sorted integer array
+ * @param size Size of the array
+ * @param lo Smallest value to count
+ * @param hi Largest value to count
+ * @return Number of elements x with lo <= x <= hi (0 if lo > hi)
+ */
+size_t binary_search_count_range(const int* arr, size_t size, int lo, int hi);
+
 /**
  * Find the insertion point for target to maintain sorted order
  * 查找目标值的插入位置以保持数组排序
@@ -122,6 +187,105 @@ BinarySearchRangeResult binary_search_range(const int* arr, size_t size, int tar
  */
 size_t binary_search_insertion_point(const int* arr, size_t size, int target);
 
+/**
+ * Galloping (exponential) search starting from a hint position
+ * 从提示位置开始的倍增（galloping）查找
+ *
+ * Probes at distances 1, 2, 4, ... from the hint until the target is
+ * bracketed, so the cost is O(log d) for a target d positions away.
+ * 从提示位置按 1, 2, 4, ... 的距离探测，代价为 O(log d)
+ *
+ * @param arr Pointer to sorted integer array
+ * @param size Size of the array
+ * @param target Target value to search for
+ * @param hint Position expected to be near target (clamped to size)
+ * @return BinarySearchResult with the index of the first occurrence
+ */
+BinarySearchResult binary_search_from_hint(const int* arr, size_t size, int target, size_t hint);
+
+/**
+ * Initialize a search cursor at the start of a sorted array
+ * 在已排序数组起始处初始化查找游标
+ *
+ * @param cursor Cursor to initialize
+ * @param arr Pointer to sorted integer array (must outlive the cursor)
+ * @param size Size of the array
+ */
+void binary_search_cursor_init(BinarySearchCursor* cursor, const int* arr, size_t size);
+
+/**
+ * Search with a cursor, galloping from where the previous lookup ended
+ * 使用游标查找，从上次查找结束的位置开始倍增探测
+ *
+ * @param cursor Cursor created by binary_search_cursor_init
+ * @param target Target value to search for
+ * @return BinarySearchResult with the index of the first occurrence
+ */
+BinarySearchResult binary_search_cursor_find(BinarySearchCursor* cursor, int target);
+
+/**
+ * Search a sorted array using an interpolation-style probe strategy
+ * 使用插值类探测策略在已排序数组中查找
+ *
+ * Uniformly distributed keys need a handful of probes where binary search
+ * needs log2(n). Whenever a probe fails to halve the range, as on skewed
+ * data, a binary step follows it, so the worst case stays logarithmic.
+ * 当某次探测未能使区间减半时（如数据分布倾斜），会追加一次二分步骤
+ *
+ * @param arr Pointer to sorted integer array
+ * @param size Size of the array
+ * @param target Target value to search for
+ * @param mode Probe strategy
+ * @return BinarySearchResult with the index of the first occurrence
+ */
+BinarySearchResult binary_search_interpolation(const int* arr, size_t size, int target,
+                                               BinarySearchMode mode);
+
+/**
+ * Choose a probe strategy by sampling the key distribution once
+ * 通过采样键分布选择探测策略（建立索引时调用一次）
+ *
+ * @param arr Pointer to sorted integer array
+ * @param size Size of the array
+ * @return The strategy expected to need the fewest probes
+ */
+BinarySearchMode binary_search_select_mode(const int* arr, size_t size);
+
+/**
+ * Build a blocked Bloom filter over a sorted array
+ * 在已排序数组上建立分块布隆过滤器
+ *
+ * Each key sets all its bits in one 64-byte block, so rejecting an absent
+ * key reads a single cache line instead of walking the binary search.
+ * 每个键的所有位都在同一个 64 字节块中，排除不存在的键只需读取一条缓存行
+ *
+ * @param filter Filter to initialize
+ * @param arr Pointer to sorted integer array (must outlive the filter)
+ * @param size Size of the array
+ * @param false_positive_rate Target share of absent keys that still need a search, in (0, 1)
+ * @return true on success, false if memory allocation fails
+ */
+bool binary_search_filter_init(BinarySearchFilter* filter, const int* arr, size_t size,
+                               double false_positive_rate);
+
+/**
+ * Search through the filter and update its counters
+ * 通过过滤器查找并更新计数器
+ *
+ * @param filter Filter created by binary_search_filter_init
+ * @param target Target value to search for
+ * @return BinarySearchResult with the index of the first occurrence
+ */
+BinarySearchResult binary_search_filtered(BinarySearchFilter* filter, int target);
+
+/**
+ * Free the memory of a filter
+ * 释放过滤器的内存
+ *
+ * @param filter Filter to free
+ */
+void binary_search_filter_free(BinarySearchFilter* filter);
+
 /**
  * Generic binary search function with custom comparison
  * 通用二分查找函数，支持自定义比较函数
@@ -0,0 +1,247 @@
+/**
+ * Binary Search over Memory-Mapped Sorted Record Files - Source File
+ * 基于内存映射的有序记录文件二分查找 - 源文件
+ */
+
+#define _XOPEN_SOURCE 700  // mmap, posix_madvise and sysconf under -std=c99
+
+#include "binary_search_file.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * Whether keys stored in the given byte order must be reversed on this host
+ * 判断给定字节序的键在本机上是否需要反转
+ */
+static bool needs_swap(BinarySearchByteOrder byte_order) {
+    const unsigned int probe = 1;
+    bool host_little = *(const unsigned char*)&probe == 1;
+
+    switch (byte_order) {
+        case BINARY_SEARCH_BYTE_ORDER_LITTLE:
+            return !host_little;
+        case BINARY_SEARCH_BYTE_ORDER_BIG:
+            return host_little;
+        default:
+            return false;
+    }
+}
+
+/**
+ * Buffer for one key, aligned for any type a comparator may read it as
+ * (C99 has no max_align_t)
+ * 单个键的缓冲区，按比较函数可能使用的任意类型对齐
+ */
+typedef union {
+    unsigned char bytes[BINARY_SEARCH_FILE_MAX_KEY_WIDTH];
+    long double long_double_value;
+    long long long_long_value;
+    void* pointer_value;
+} AlignedKey;
+
+/**
+ * Copy the key of a record into out, converted to host byte order
+ * 将记录的键复制到 out 并转换为本机字节序
+ */
+static void load_key(const BinarySearchFile* file, size_t index, unsigned char* out) {
+    const unsigned char* key = file->records + index * file->format.record_size + file->format.key_offset;
+    size_t width = file->format.key_width;
+
+    if (needs_swap(file->format.byte_order)) {
+        for (size_t i = 0; i < width; i++) {
+            out[i] = key[width - 1 - i];
+        }
+    } else {
+        memcpy(out, key, width);
+    }
+}
+
+/**
+ * Map a sorted record file and cache the keys of its top search levels
+ * 映射有序记录文件并缓存搜索树顶层的键
+ */
+bool binary_search_file_open(BinarySearchFile* file, const char* path,
+                             const BinarySearchFileFormat* format, size_t cache_bytes) {
+    if (file == NULL || path == NULL || format == NULL || format->compar == NULL
+        || format->key_width == 0 || format->key_width > BINARY_SEARCH_FILE_MAX_KEY_WIDTH
+        || format->record_size < format->key_width
+        || format->key_offset > format->record_size - format->key_width) {
+        errno = EINVAL;
+        return false;
+    }
+
+    memset(file, 0, sizeof(*file));
+    file->format = *format;
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        return false;
+    }
+
+    file->count = (size_t)info.st_size / format->record_size;
+    file->mapped_size = file->count * format->record_size;
+    if (file->count == 0) {
+        close(fd);
+        return true;
+    }
+
+    void* mapping = mmap(NULL, file->mapped_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        return false;
+    }
+    file->records = mapping;
+
+    // Lookups jump around the file: avoid reading ahead pages they will not use
+    posix_madvise(mapping, file->mapped_size, POSIX_MADV_RANDOM);
+
+    long page_size = sysconf(_SC_PAGESIZE);
+    size_t page_records = page_size > 0 ? (size_t)page_size / format->record_size : 1;
+    if (page_records == 0) {
+        page_records = 1;
+    }
+
+    // By default, budget for a stride of at most a page of records: the last
+    // halving leaves more than half a page, so that takes under
+    // 2 * count / page_records + 1 keys
+    if (cache_bytes == 0) {
+        size_t default_keys = 2 * (file->count / page_records) + 3;
+        size_t max_default_keys = BINARY_SEARCH_FILE_MAX_DEFAULT_CACHE_BYTES / format->key_width;
+        cache_bytes = (default_keys < max_default_keys ? default_keys : max_default_keys) * format->key_width;
+    }
+    size_t max_keys = cache_bytes / format->key_width;
+
+    // Cache the keys of the top levels of the search: each extra level halves
+    // the stride, while it exceeds a page of records and the keys fit in the
+    // budget. Opening reads only these keys.
+    file->stride = file->count;
+    file->cached_count = max_keys > 0 ? 1 : 0;
+    for (unsigned int levels = 1; max_keys > 0 && file->stride > page_records; levels++) {
+        size_t stride = file->count >> levels;
+        size_t keys = (file->count - 1) / stride + 1;
+        if (keys > max_keys) {
+            break;
+        }
+        file->stride = stride;
+        file->cached_count = keys;
+    }
+
+    if (file->cached_count == 0) {
+        return true;
+    }
+    file->cached_keys = malloc(file->cached_count * format->key_width);
+    if (file->cached_keys == NULL) {
+        munmap(mapping, file->mapped_size);
+        memset(file, 0, sizeof(*file));
+        errno = ENOMEM;
+        return false;
+    }
+    // malloc'd storage at multiples of key_width stays aligned for the key's type
+    for (size_t i = 0; i < file->cached_count; i++) {
+        load_key(file, i * file->stride, file->cached_keys + i * format->key_width);
+    }
+
+    return true;
+}
+
+/**
+ * Unmap a file opened by binary_search_file_open and free its cache
+ * 解除文件映射并释放缓存
+ */
+void binary_search_file_close(BinarySearchFile* file) {
+    if (file == NULL) {
+        return;
+    }
+
+    if (file->records != NULL) {
+        munmap((void*)file->records, file->mapped_size);
+    }
+    free(file->cached_keys);
+    memset(file, 0, sizeof(*file));
+}
+
+/**
+ * Find the first record whose key is not less than key
+ * 查找第一个键不小于目标键的记录
+ */
+size_t binary_search_file_lower_bound(const BinarySearchFile* file, const void* key) {
+    if (file == NULL || key == NULL || file->count == 0) {
+        return 0;
+    }
+
+    // Count the cached keys less than key, without touching the file
+    size_t width = file->format.key_width;
+    size_t left = 0;
+    size_t right = file->cached_count;
+    while (left < right) {
+        size_t mid = left + (right - left) / 2;
+        if (file->format.compar(key, file->cached_keys + mid * width) > 0) {
+            left = mid + 1;
+        } else {
+            right = mid;
+        }
+    }
+
+    // The answer lies after the last smaller cached key and at or before the next one
+    AlignedKey record_key;
+    size_t lo = left == 0 ? 0 : (left - 1) * file->stride + 1;
+    size_t hi = left < file->cached_count ? left * file->stride : file->count;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        load_key(file, mid, record_key.bytes);
+        if (file->format.compar(key, record_key.bytes) > 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    return lo;
+}
+
+/**
+ * Find the first record with the given key
+ * 查找具有给定键的第一条记录
+ */
+BinarySearchResult binary_search_file_find(const BinarySearchFile* file, const void* key) {
+    BinarySearchResult result = {BINARY_SEARCH_NOT_FOUND, false};
+
+    if (file == NULL || key == NULL) {
+        return result;
+    }
+
+    size_t index = binary_search_file_lower_bound(file, key);
+    if (index < file->count) {
+        AlignedKey record_key;
+        load_key(file, index, record_key.bytes);
+        if (file->format.compar(key, record_key.bytes) == 0) {
+            result.index = (ptrdiff_t)index;
+            result.found = true;
+        }
+    }
+
+    return result;
+}
+
+/**
+ * Access a record by index
+ * 按下标访问记录
+ */
+const void* binary_search_file_record(const BinarySearchFile* file, size_t index) {
+    if (file == NULL || index >= file->count) {
+        return NULL;
+    }
+
+    return file->records + index * file->format.record_size;
+}
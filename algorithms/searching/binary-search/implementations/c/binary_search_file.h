@@ -0,0 +1,145 @@
+/**
+ * Binary Search over Memory-Mapped Sorted Record Files
+ * 基于内存映射的有序记录文件二分查找
+ *
+ * The file is a sequence of fixed-width records sorted by a key stored at
+ * a fixed offset in each record. When the file is opened, the keys of the
+ * top levels of the binary search are copied into RAM; a lookup searches
+ * those keys first and then only the records between two of them.
+ * 文件由按键排序的定长记录组成。打开时将二分查找顶层的键缓存到内存中，
+ * 查找先在缓存中定位，再只搜索两个缓存键之间的记录。
+ */
+
+#ifndef BINARY_SEARCH_FILE_H
+#define BINARY_SEARCH_FILE_H
+
+#include "binary_search.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Largest supported key width in bytes
+ * 支持的最大键宽度（字节）
+ */
+#define BINARY_SEARCH_FILE_MAX_KEY_WIDTH 64
+
+/**
+ * Cap on the key cache budget binary_search_file_open picks when given 0
+ * binary_search_file_open 的 cache_bytes 为 0 时自动选择的键缓存预算上限
+ */
+#define BINARY_SEARCH_FILE_MAX_DEFAULT_CACHE_BYTES (1024 * 1024)
+
+/**
+ * Byte order of the keys stored in the file
+ * 文件中键的字节序
+ */
+typedef enum {
+    BINARY_SEARCH_BYTE_ORDER_NATIVE,    // Same as the host
+    BINARY_SEARCH_BYTE_ORDER_LITTLE,    // Least significant byte first
+    BINARY_SEARCH_BYTE_ORDER_BIG        // Most significant byte first
+} BinarySearchByteOrder;
+
+/**
+ * Layout of the records in a sorted file
+ * 有序文件中记录的布局
+ */
+typedef struct {
+    size_t record_size;                 // Bytes per record
+    size_t key_offset;                  // Offset of the key inside a record
+    size_t key_width;                   // Bytes per key (1..BINARY_SEARCH_FILE_MAX_KEY_WIDTH)
+    BinarySearchByteOrder byte_order;   // Byte order of the key in the file
+    int (*compar)(const void*, const void*);    // Compares a search key with a record key
+                                                // converted to host order, as in binary_search_generic
+} BinarySearchFileFormat;
+
+/**
+ * Open sorted record file
+ * 已打开的有序记录文件
+ */
+typedef struct {
+    const unsigned char* records;   // Mapped records (NULL when the file is empty)
+    size_t count;                   // Number of whole records
+    size_t mapped_size;             // Bytes mapped
+    BinarySearchFileFormat format;  // Record layout
+    unsigned char* cached_keys;     // Host-order keys of records 0, stride, 2 * stride, ...
+                                    // (NULL when the budget holds no key)
+    size_t cached_count;            // Number of cached keys
+    size_t stride;                  // Records between cached keys
+} BinarySearchFile;
+
+/**
+ * Map a sorted record file and cache the keys of its top search levels
+ * 映射有序记录文件并缓存搜索树顶层的键
+ *
+ * The keys of records 0, stride, 2 * stride, ... are cached, where
+ * stride = count >> levels and levels grows while the stride exceeds a page
+ * of records and the keys fit in cache_bytes. Opening reads one page per
+ * cached key, so its cost depends on the budget rather than the file size.
+ *
+ * Once the stride is at most a page of records, a lookup reads at most two
+ * pages of the file. A budget too small for that leaves a larger stride,
+ * and a lookup then reads at most 2 + ceil(log2(stride / records per page))
+ * pages. The default budget holds enough keys for two pages per lookup, up
+ * to BINARY_SEARCH_FILE_MAX_DEFAULT_CACHE_BYTES; with 8-byte keys and 4 KiB
+ * pages that covers files of about 256 MiB.
+ *
+ * The mapping is advised for random access. A trailing partial record is
+ * ignored.
+ * 缓存步长为 count >> levels 的键，打开时只读取这些键所在的页；
+ * 步长不超过一页记录时每次查找最多读取两页
+ *
+ * @param file Receives the open file
+ * @param path Path of the file, sorted ascending by compar
+ * @param format Record layout and key comparator
+ * @param cache_bytes Memory budget for cached keys, 0 to size it from the file
+ *                    (at most BINARY_SEARCH_FILE_MAX_DEFAULT_CACHE_BYTES)
+ * @return true on success; false on invalid format or I/O errors (errno is set)
+ */
+bool binary_search_file_open(BinarySearchFile* file, const char* path,
+                             const BinarySearchFileFormat* format, size_t cache_bytes);
+
+/**
+ * Unmap a file opened by binary_search_file_open and free its cache
+ * 解除文件映射并释放缓存
+ *
+ * @param file File to close
+ */
+void binary_search_file_close(BinarySearchFile* file);
+
+/**
+ * Find the first record whose key is not less than key
+ * 查找第一个键不小于目标键的记录
+ *
+ * @param file Open file
+ * @param key Key in host order, passed to compar as its first argument
+ * @return Index of that record, or the record count if there is none
+ */
+size_t binary_search_file_lower_bound(const BinarySearchFile* file, const void* key);
+
+/**
+ * Find the first record with the given key
+ * 查找具有给定键的第一条记录
+ *
+ * @param file Open file
+ * @param key Key in host order, passed to compar as its first argument
+ * @return BinarySearchResult with the index of the first matching record
+ */
+BinarySearchResult binary_search_file_find(const BinarySearchFile* file, const void* key);
+
+/**
+ * Access a record by index
+ * 按下标访问记录
+ *
+ * @param file Open file
+ * @param index Record index
+ * @return Pointer to the record inside the mapping, or NULL if out of range
+ */
+const void* binary_search_file_record(const BinarySearchFile* file, size_t index);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BINARY_SEARCH_FILE_H */
@@ -35,7 +35,7 @@ void demo_basic_operations(void) {
 
         printf("Searching for %d: ", target);
         if (result.found) {
-            printf("Found at index %d\n", result.index);
+            printf("Found at index %td\n", result.index);
         } else {
             printf("Not found\n");
         }
@@ -56,7 +56,7 @@ void demo_recursive_search(void) {
 
     printf("Recursive search for %d: ", target);
     if (result.found) {
-        printf("Found at index %d\n", result.index);
+        printf("Found at index %td\n", result.index);
     } else {
         printf("Not found\n");
     }
@@ -76,7 +76,7 @@ void demo_verbose_search(void) {
 
     printf("\nResult: ");
     if (result.found) {
-        printf("Found at index %d in %d steps\n", result.index, result.steps);
+        printf("Found at index %td in %d steps\n", result.index, result.steps);
     } else {
         printf("Not found after %d steps\n", result.steps);
     }
@@ -104,7 +104,7 @@ void demo_duplicate_handling(void) {
     BinarySearchResult first = binary_search_first_occurrence(arr, size, target);
     printf("First occurrence of %d: ", target);
     if (first.found) {
-        printf("index %d\n", first.index);
+        printf("index %td\n", first.index);
     } else {
         printf("not found\n");
     }
@@ -113,7 +113,7 @@ void demo_duplicate_handling(void) {
     BinarySearchResult last = binary_search_last_occurrence(arr, size, target);
     printf("Last occurrence of %d: ", target);
     if (last.found) {
-        printf("index %d\n", last.index);
+        printf("index %td\n", last.index);
     } else {
         printf("not found\n");
     }
@@ -122,11 +122,14 @@ void demo_duplicate_handling(void) {
     BinarySearchRangeResult range = binary_search_range(arr, size, target);
     printf("Range of %d: ", target);
     if (range.found) {
-        printf("[%d, %d]\n", range.first_index, range.last_index);
+        printf("[%td, %td]\n", range.first_index, range.last_index);
     } else {
         printf("not found\n");
     }
 
+    // Count in a value range
+    printf("Values in [2, 4]: %zu\n", binary_search_count_range(arr, size, 2, 4));
+
     printf("\n");
 }
 
@@ -200,7 +203,7 @@ void demo_edge_cases(void) {
     // Single element
     int single[] = {42};
     result = binary_search(single, 1, 42);
-    printf("Single element [42], search 42: %s at index %d\n",
+    printf("Single element [42], search 42: %s at index %td\n",
            result.found ? "found" : "not found", result.index);
 
     result = binary_search(single, 1, 10);
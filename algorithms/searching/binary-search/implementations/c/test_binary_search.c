@@ -3,16 +3,46 @@
  * 使用Unity框架的二分查找测试套件
  */
 
+#define _XOPEN_SOURCE 700  // mkstemp, ftruncate and mmap under -std=c99
+
 #include "unity.h"
 #include "binary_search.h"
+#include "binary_search_file.h"
+#include <stdio.h>
+#include <limits.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 
+#ifdef __unix__
+#include <sys/mman.h>
+#include <unistd.h>
+#if SIZE_MAX > 0xFFFFFFFFu
+#define HAVE_LARGE_MMAP_TEST 1
+#endif
+#endif
+
 // Test helper functions
 static int int_compare(const void* a, const void* b) {
     return *(const int*)a - *(const int*)b;
 }
 
+#ifdef __unix__
+static int uint64_compare(const void* a, const void* b) {
+    uint64_t x, y;
+    memcpy(&x, a, sizeof(x));
+    memcpy(&y, b, sizeof(y));
+    return (x > y) - (x < y);
+}
+
+static int uint16_compare(const void* a, const void* b) {
+    uint16_t x, y;
+    memcpy(&x, a, sizeof(x));
+    memcpy(&y, b, sizeof(y));
+    return (x > y) - (x < y);
+}
+#endif
+
 // Test setup and teardown
 void setUp(void) {
     // Called before each test
@@ -171,6 +201,12 @@ void test_binary_search_range(void) {
     TEST_ASSERT_FALSE(result.found);
     TEST_ASSERT_EQUAL(-1, result.first_index);
     TEST_ASSERT_EQUAL(-1, result.last_index);
+
+    // Test counting values in [lo, hi]
+    TEST_ASSERT_EQUAL(5, binary_search_count_range(arr, size, 2, 3));
+    TEST_ASSERT_EQUAL(8, binary_search_count_range(arr, size, INT_MIN, INT_MAX));
+    TEST_ASSERT_EQUAL(0, binary_search_count_range(arr, size, 6, 9));
+    TEST_ASSERT_EQUAL(0, binary_search_count_range(arr, size, 3, 2));
 }
 
 // Test insertion point
@@ -251,6 +287,328 @@ void test_binary_search_verbose(void) {
     TEST_ASSERT_EQUAL(0, result.steps);
 }
 
+// Test the branchless kernels against a linear scan on random arrays with duplicates
+void test_binary_search_random(void) {
+    int arr[100];
+    srand(37);
+
+    for (size_t size = 0; size <= 100; size += 3) {
+        for (size_t i = 0; i < size; i++) {
+            arr[i] = rand() % 20;
+        }
+        qsort(arr, size, sizeof(int), int_compare);
+
+        for (int target = -1; target <= 20; target++) {
+            int first = -1;
+            int last = -1;
+            size_t insertion = size;
+            for (size_t i = 0; i < size; i++) {
+                if (arr[i] == target) {
+                    first = first < 0 ? (int)i : first;
+                    last = (int)i;
+                }
+                if (arr[i] >= target && insertion == size) {
+                    insertion = i;
+                }
+            }
+
+            BinarySearchResult result = binary_search(arr, size, target);
+            TEST_ASSERT_EQUAL(first >= 0, result.found);
+            if (result.found) {
+                TEST_ASSERT_EQUAL(target, arr[result.index]);
+            }
+            TEST_ASSERT_EQUAL(first, binary_search_first_occurrence(arr, size, target).index);
+            TEST_ASSERT_EQUAL(last, binary_search_last_occurrence(arr, size, target).index);
+            TEST_ASSERT_EQUAL(insertion, binary_search_insertion_point(arr, size, target));
+
+            BinarySearchRangeResult range = binary_search_range(arr, size, target);
+            TEST_ASSERT_EQUAL(first >= 0, range.found);
+            TEST_ASSERT_EQUAL(first, range.first_index);
+            TEST_ASSERT_EQUAL(last, range.last_index);
+
+            for (int hi = target - 1; hi <= target + 5; hi++) {
+                size_t expected = 0;
+                for (size_t i = 0; i < size; i++) {
+                    expected += arr[i] >= target && arr[i] <= hi;
+                }
+                TEST_ASSERT_EQUAL(expected, binary_search_count_range(arr, size, target, hi));
+            }
+        }
+    }
+}
+
+// Test every interpolation mode against the first occurrence on uniform,
+// exponential and duplicate-heavy keys, and the mode selector
+void test_binary_search_interpolation(void) {
+    static int arr[3000];
+    const BinarySearchMode modes[] = {
+        BINARY_SEARCH_MODE_BINARY, BINARY_SEARCH_MODE_INTERPOLATION,
+        BINARY_SEARCH_MODE_INTERPOLATION_SEQUENTIAL, BINARY_SEARCH_MODE_THREE_POINT
+    };
+    srand(41);
+
+    for (int shape = 0; shape < 3; shape++) {
+        size_t size = sizeof(arr) / sizeof(arr[0]);
+        int value = -1000000;
+        for (size_t i = 0; i < size; i++) {
+            if (shape == 0) {
+                value += rand() % 1000;                 // Near-uniform
+            } else if (shape == 1) {
+                value = (int)(i * i * i / 16);          // Strongly curved
+            } else {
+                value += rand() % 50 == 0 ? 100000 : 0; // Long duplicate runs
+            }
+            arr[i] = value;
+        }
+        if (shape == 0) {
+            TEST_ASSERT_NOT_EQUAL(BINARY_SEARCH_MODE_BINARY, binary_search_select_mode(arr, size));
+        }
+
+        for (size_t i = 0; i < size; i += 7) {
+            int targets[] = {arr[i], arr[i] + 1, arr[i] - 1};
+            for (size_t t = 0; t < 3; t++) {
+                BinarySearchResult expected = binary_search_first_occurrence(arr, size, targets[t]);
+                for (size_t m = 0; m < 4; m++) {
+                    BinarySearchResult result = binary_search_interpolation(arr, size, targets[t], modes[m]);
+                    TEST_ASSERT_EQUAL(expected.found, result.found);
+                    TEST_ASSERT_EQUAL(expected.index, result.index);
+                }
+            }
+        }
+    }
+
+    TEST_ASSERT_FALSE(binary_search_interpolation(NULL, 0, 5, BINARY_SEARCH_MODE_INTERPOLATION).found);
+    TEST_ASSERT_EQUAL(BINARY_SEARCH_MODE_BINARY, binary_search_select_mode(NULL, 0));
+}
+
+// Test galloping from every hint, and a cursor walking up, down and at random
+void test_binary_search_gallop(void) {
+    int arr[] = {1, 3, 3, 3, 5, 7, 9, 9, 11, 13, 15, 17, 19};
+    size_t size = sizeof(arr) / sizeof(arr[0]);
+    BinarySearchCursor cursor;
+
+    for (int target = 0; target <= 20; target++) {
+        BinarySearchResult expected = binary_search_first_occurrence(arr, size, target);
+        for (size_t hint = 0; hint <= size + 2; hint++) {
+            BinarySearchResult result = binary_search_from_hint(arr, size, target, hint);
+            TEST_ASSERT_EQUAL(expected.found, result.found);
+            TEST_ASSERT_EQUAL(expected.index, result.index);
+        }
+    }
+
+    binary_search_cursor_init(&cursor, arr, size);
+    for (int round = 0; round < 3; round++) {
+        for (int i = 0; i <= 20; i++) {
+            int target = round == 0 ? i : (round == 1 ? 20 - i : rand() % 21);
+            BinarySearchResult expected = binary_search_first_occurrence(arr, size, target);
+            BinarySearchResult result = binary_search_cursor_find(&cursor, target);
+            TEST_ASSERT_EQUAL(expected.found, result.found);
+            TEST_ASSERT_EQUAL(expected.index, result.index);
+        }
+    }
+
+    TEST_ASSERT_FALSE(binary_search_from_hint(NULL, 0, 5, 0).found);
+    binary_search_cursor_init(&cursor, NULL, 10);
+    TEST_ASSERT_FALSE(binary_search_cursor_find(&cursor, 5).found);
+}
+
+// Test indices beyond 2^32 on a memory-mapped sparse file of 2^32 + 64 ints:
+// zeros (file holes, never stored) followed by 1..64 at the end
+void test_binary_search_beyond_4g_elements(void) {
+#ifdef HAVE_LARGE_MMAP_TEST
+    const size_t zeros = (size_t)1 << 32;
+    const size_t size = zeros + 64;
+    char path[] = "/tmp/binary_search_large_XXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0) {
+        TEST_IGNORE_MESSAGE("cannot create a temporary file");
+    }
+    unlink(path);
+
+    int tail[64];
+    for (int i = 0; i < 64; i++) {
+        tail[i] = i + 1;
+    }
+    off_t bytes = (off_t)(size * sizeof(int));
+    if (ftruncate(fd, bytes) != 0
+        || pwrite(fd, tail, sizeof(tail), (off_t)(zeros * sizeof(int))) != (ssize_t)sizeof(tail)) {
+        close(fd);
+        TEST_IGNORE_MESSAGE("filesystem cannot hold a 16 GiB sparse file");
+    }
+    const int* arr = mmap(NULL, (size_t)bytes, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (arr == MAP_FAILED) {
+        TEST_IGNORE_MESSAGE("cannot map 16 GiB of address space");
+    }
+
+    BinarySearchResult result = binary_search(arr, size, 1);
+    TEST_ASSERT_TRUE(result.found);
+    TEST_ASSERT_TRUE(result.index == (ptrdiff_t)zeros);
+
+    result = binary_search(arr, size, 64);
+    TEST_ASSERT_TRUE(result.index == (ptrdiff_t)(size - 1));
+
+    result = binary_search(arr, size, 65);
+    TEST_ASSERT_FALSE(result.found);
+    TEST_ASSERT_TRUE(result.index == BINARY_SEARCH_NOT_FOUND);
+
+    result = binary_search_last_occurrence(arr, size, 0);
+    TEST_ASSERT_TRUE(result.index == (ptrdiff_t)(zeros - 1));
+
+    BinarySearchRangeResult range = binary_search_range(arr, size, 0);
+    TEST_ASSERT_TRUE(range.first_index == 0);
+    TEST_ASSERT_TRUE(range.last_index == (ptrdiff_t)(zeros - 1));
+
+    TEST_ASSERT_TRUE(binary_search_insertion_point(arr, size, 33) == zeros + 32);
+    TEST_ASSERT_TRUE(binary_search_from_hint(arr, size, 10, 0).index == (ptrdiff_t)(zeros + 9));
+    TEST_ASSERT_TRUE(binary_search_interpolation(arr, size, 40, BINARY_SEARCH_MODE_INTERPOLATION).index
+                     == (ptrdiff_t)(zeros + 39));
+
+    munmap((void*)arr, (size_t)bytes);
+#else
+    TEST_IGNORE_MESSAGE("needs a 64-bit POSIX system");
+#endif
+}
+
+// Test searching a sorted record file: 12-byte records holding a 4-byte
+// payload followed by a big-endian 8-byte key, with duplicate keys
+void test_binary_search_file(void) {
+#ifdef __unix__
+    const size_t count = 100000;
+    char path[] = "/tmp/binary_search_records_XXXXXX";
+    int fd = mkstemp(path);
+    TEST_ASSERT_TRUE(fd >= 0);
+    close(fd);
+
+    FILE* out = fopen(path, "wb");
+    TEST_ASSERT_NOT_NULL(out);
+    for (size_t i = 0; i < count; i++) {
+        unsigned char record[12];
+        uint32_t payload = (uint32_t)i;
+        uint64_t key = (uint64_t)(i / 3) * 5 + ((uint64_t)1 << 40);
+        memcpy(record, &payload, sizeof(payload));
+        for (int b = 0; b < 8; b++) {
+            record[4 + b] = (unsigned char)(key >> (56 - 8 * b));
+        }
+        fwrite(record, sizeof(record), 1, out);
+    }
+    fputc(0, out);  // Trailing partial record is ignored
+    fclose(out);
+
+    BinarySearchFileFormat format = {12, 4, 8, BINARY_SEARCH_BYTE_ORDER_BIG, uint64_compare};
+    // Default budget, a budget of a few keys, and one too small for any key
+    size_t budgets[] = {0, 64, 4};
+    for (size_t b = 0; b < 3; b++) {
+        BinarySearchFile file;
+        TEST_ASSERT_TRUE(binary_search_file_open(&file, path, &format, budgets[b]));
+        TEST_ASSERT_EQUAL(count, file.count);
+        size_t budget = budgets[b] != 0 ? budgets[b] : BINARY_SEARCH_FILE_MAX_DEFAULT_CACHE_BYTES;
+        TEST_ASSERT_TRUE(file.cached_count * 8 <= budget);
+        if (budgets[b] == 0) {
+            // The default budget leaves at most a page of records between cached
+            // keys, with about two keys per page of the file
+            size_t page_records = (size_t)sysconf(_SC_PAGESIZE) / 12;
+            TEST_ASSERT_TRUE(file.stride <= page_records);
+            TEST_ASSERT_TRUE(file.cached_count <= 2 * (count / page_records) + 3);
+        }
+
+        for (size_t i = 0; i < count; i += 97) {
+            uint64_t key = (uint64_t)(i / 3) * 5 + ((uint64_t)1 << 40);
+            BinarySearchResult result = binary_search_file_find(&file, &key);
+            TEST_ASSERT_TRUE(result.found);
+            TEST_ASSERT_TRUE(result.index == (ptrdiff_t)(i / 3 * 3));
+
+            uint32_t payload;
+            memcpy(&payload, binary_search_file_record(&file, (size_t)result.index), sizeof(payload));
+            TEST_ASSERT_EQUAL(i / 3 * 3, payload);
+
+            key += 1;  // Between stored keys
+            TEST_ASSERT_FALSE(binary_search_file_find(&file, &key).found);
+            size_t next = i / 3 * 3 + 3 < count ? i / 3 * 3 + 3 : count;
+            TEST_ASSERT_EQUAL(next, binary_search_file_lower_bound(&file, &key));
+        }
+
+        uint64_t below = 0;
+        uint64_t above = UINT64_MAX;
+        TEST_ASSERT_EQUAL(0, binary_search_file_lower_bound(&file, &below));
+        TEST_ASSERT_EQUAL(count, binary_search_file_lower_bound(&file, &above));
+        TEST_ASSERT_NULL(binary_search_file_record(&file, count));
+        binary_search_file_close(&file);
+    }
+
+    // A little-endian 2-byte key at the start of 3-byte records
+    out = fopen(path, "wb");
+    TEST_ASSERT_NOT_NULL(out);
+    for (unsigned int i = 0; i < 5000; i++) {
+        unsigned char record[3] = {(unsigned char)(i * 2), (unsigned char)((i * 2) >> 8), 0xAB};
+        fwrite(record, sizeof(record), 1, out);
+    }
+    fclose(out);
+
+    BinarySearchFileFormat little = {3, 0, 2, BINARY_SEARCH_BYTE_ORDER_LITTLE, uint16_compare};
+    BinarySearchFile file;
+    TEST_ASSERT_TRUE(binary_search_file_open(&file, path, &little, 0));
+    uint16_t key = 4000;
+    TEST_ASSERT_EQUAL(2000, binary_search_file_find(&file, &key).index);
+    key = 4001;
+    TEST_ASSERT_EQUAL(2001, binary_search_file_lower_bound(&file, &key));
+    binary_search_file_close(&file);
+
+    // Empty files open; invalid layouts are rejected
+    out = fopen(path, "wb");
+    TEST_ASSERT_NOT_NULL(out);
+    fclose(out);
+    TEST_ASSERT_TRUE(binary_search_file_open(&file, path, &little, 0));
+    TEST_ASSERT_FALSE(binary_search_file_find(&file, &key).found);
+    binary_search_file_close(&file);
+
+    BinarySearchFileFormat invalid = {4, 3, 2, BINARY_SEARCH_BYTE_ORDER_NATIVE, uint16_compare};
+    TEST_ASSERT_FALSE(binary_search_file_open(&file, path, &invalid, 0));
+
+    unlink(path);
+#else
+    TEST_IGNORE_MESSAGE("needs a POSIX system");
+#endif
+}
+
+// Test the Bloom-filtered search: no false negatives, a false-positive rate
+// near the target, and counters that add up
+void test_binary_search_filtered(void) {
+    static int arr[20000];
+    const double rates[] = {0.1, 0.01, 0.001};
+    srand(50);
+
+    for (size_t r = 0; r < 3; r++) {
+        for (size_t i = 0; i < 20000; i++) {
+            arr[i] = (rand() % 1000000) * 2;  // Even keys only
+        }
+        qsort(arr, 20000, sizeof(int), int_compare);
+
+        BinarySearchFilter filter;
+        TEST_ASSERT_TRUE(binary_search_filter_init(&filter, arr, 20000, rates[r]));
+        TEST_ASSERT_EQUAL(0, (uintptr_t)filter.blocks % 64);
+
+        for (size_t i = 0; i < 20000; i++) {
+            TEST_ASSERT_EQUAL(binary_search(arr, 20000, arr[i]).index, binary_search_filtered(&filter, arr[i]).index);
+        }
+        const size_t misses = 200000;
+        for (size_t i = 0; i < misses; i++) {
+            TEST_ASSERT_FALSE(binary_search_filtered(&filter, (rand() % 1000000) * 2 + 1).found);
+        }
+
+        TEST_ASSERT_EQUAL(20000, filter.hits);
+        TEST_ASSERT_EQUAL(misses, filter.definite_misses + filter.false_positives);
+        TEST_ASSERT_TRUE((double)filter.false_positives / misses <= 2 * rates[r]);
+        binary_search_filter_free(&filter);
+        TEST_ASSERT_NULL(filter.blocks);
+    }
+
+    BinarySearchFilter empty;
+    TEST_ASSERT_TRUE(binary_search_filter_init(&empty, NULL, 0, 0.01));
+    TEST_ASSERT_FALSE(binary_search_filtered(&empty, 5).found);
+    binary_search_filter_free(&empty);
+}
+
 // Main test runner
 int main(void) {
     UNITY_BEGIN();
@@ -264,6 +622,12 @@ int main(void) {
     RUN_TEST(test_binary_search_insertion_point);
     RUN_TEST(test_binary_search_generic);
     RUN_TEST(test_binary_search_verbose);
+    RUN_TEST(test_binary_search_random);
+    RUN_TEST(test_binary_search_interpolation);
+    RUN_TEST(test_binary_search_gallop);
+    RUN_TEST(test_binary_search_beyond_4g_elements);
+    RUN_TEST(test_binary_search_file);
+    RUN_TEST(test_binary_search_filtered);
 
     return UNITY_END();
 }
\ No newline at end of file
@@ -9,224 +9,4019 @@
 #include <iostream>
 #include <vector>
 #include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <new>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define BINARY_SEARCH_HAVE_AVX2 1
+#endif
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#if defined(__unix__) && SIZE_MAX > 0xFFFFFFFFu
+#include <cstdlib>
+#include <sys/mman.h>
+#include <unistd.h>
+#define BINARY_SEARCH_HAVE_LARGE_MMAP 1
+#endif
+
+/**
+ * Branchless lower bound over a sorted range.
+ *
+ * Instead of a three-way branch on each probe, the remaining length
+ * halves every step and the base pointer advances by a conditional move,
+ * so random queries cause no mispredictions and every search runs
+ * exactly ceil(log2(n)) iterations.
+ *
+ * @param data Pointer to the first element
+ * @param n Number of elements
+ * @param target Element to search for
+ * @return Index of the first element not less than target, n if none
+ */
+template<typename T>
+size_t lowerBoundBranchless(const T* data, size_t n, const T& target) {
+    if (n == 0) {
+        return 0;
+    }
+
+    const T* base = data;
+    while (n > 1) {
+        size_t half = n / 2;
+        base = (base[half] < target) ? base + half : base;
+        n -= half;
+    }
+    return (base - data) + (*base < target);
+}
+
+/**
+ * Branchless upper bound over a sorted range.
+ *
+ * @param data Pointer to the first element
+ * @param n Number of elements
+ * @param target Element to search for
+ * @return Index of the first element greater than target, n if none
+ */
+template<typename T>
+size_t upperBoundBranchless(const T* data, size_t n, const T& target) {
+    if (n == 0) {
+        return 0;
+    }
+
+    const T* base = data;
+    while (n > 1) {
+        size_t half = n / 2;
+        base = (target < base[half]) ? base : base + half;
+        n -= half;
+    }
+    return (base - data) + !(target < *base);
+}
+
+/**
+ * Index returned by the search functions when the target is absent.
+ * Indices are std::ptrdiff_t, so arrays beyond 2^31 elements, such as
+ * memory-mapped key files, are searched without truncation.
+ */
+constexpr std::ptrdiff_t notFound = -1;
+
+/**
+ * Performs binary search on a sorted range of any length.
+ *
+ * @param data Pointer to the first element
+ * @param n Number of elements
+ * @param target Element to search for
+ * @return Index of the first occurrence of target, notFound otherwise
+ */
+std::ptrdiff_t binarySearch(const int* data, size_t n, int target) {
+    size_t index = lowerBoundBranchless(data, n, target);
+    if (index < n && data[index] == target) {
+        return static_cast<std::ptrdiff_t>(index);
+    }
+    return notFound;
+}
+
+/**
+ * Performs binary search on a sorted vector using iterative approach.
+ *
+ * @param arr Sorted vector of comparable elements
+ * @param target Element to search for
+ * @return Index of target if found, notFound otherwise
+ */
+std::ptrdiff_t binarySearch(const std::vector<int>& arr, int target) {
+    return binarySearch(arr.data(), arr.size(), target);
+}
+
+/**
+ * Performs binary search on a sorted vector using recursive approach.
+ *
+ * @param arr Sorted vector of comparable elements
+ * @param target Element to search for
+ * @param left Left boundary
+ * @param right Right boundary
+ * @return Index of target if found, notFound otherwise
+ */
+std::ptrdiff_t binarySearchRecursive(const std::vector<int>& arr, int target, std::ptrdiff_t left, std::ptrdiff_t right) {
+    if (left > right) {
+        return notFound;
+    }
+
+    std::ptrdiff_t mid = left + (right - left) / 2;
+
+    if (arr[mid] == target) {
+        return mid;
+    } else if (arr[mid] < target) {
+        return binarySearchRecursive(arr, target, mid + 1, right);
+    } else {
+        return binarySearchRecursive(arr, target, left, mid - 1);
+    }
+}
+
+/**
+ * Wrapper function for recursive binary search.
+ */
+std::ptrdiff_t binarySearchRecursive(const std::vector<int>& arr, int target) {
+    if (arr.empty()) {
+        return notFound;
+    }
+    return binarySearchRecursive(arr, target, 0, static_cast<std::ptrdiff_t>(arr.size()) - 1);
+}
+
+/**
+ * Binary search with step-by-step visualization.
+ *
+ * @param arr Sorted vector to search in
+ * @param target Element to search for
+ * @return Index of target if found, notFound otherwise
+ */
+std::ptrdiff_t binarySearchVerbose(const std::vector<int>& arr, int target) {
+    if (arr.empty()) {
+        std::cout << "Empty array provided" << std::endl;
+        return notFound;
+    }
+
+    std::ptrdiff_t left = 0;
+    std::ptrdiff_t right = static_cast<std::ptrdiff_t>(arr.size()) - 1;
+    int steps = 0;
+
+    std::cout << "Searching for " << target << " in array: [";
+    for (size_t i = 0; i < arr.size(); ++i) {
+        std::cout << arr[i];
+        if (i < arr.size() - 1) std::cout << ", ";
+    }
+    std::cout << "]" << std::endl;
+    std::cout << "Array length: " << arr.size() << std::endl;
+
+    while (left <= right) {
+        steps++;
+        std::ptrdiff_t mid = left + (right - left) / 2;
+
+        std::cout << "\nStep " << steps << ":" << std::endl;
+        std::cout << "  left=" << left << ", right=" << right << ", mid=" << mid << std::endl;
+        std::cout << "  arr[" << mid << "] = " << arr[mid] << std::endl;
+
+        if (arr[mid] == target) {
+            std::cout << "  Target found at index " << mid << "!" << std::endl;
+            return mid;
+        } else if (arr[mid] < target) {
+            std::cout << "  " << arr[mid] << " < " << target << ", search right half" << std::endl;
+            left = mid + 1;
+        } else {
+            std::cout << "  " << arr[mid] << " > " << target << ", search left half" << std::endl;
+            right = mid - 1;
+        }
+    }
+
+    std::cout << "\nTarget " << target << " not found in array after " << steps << " steps" << std::endl;
+    return notFound;
+}
+
+/**
+ * Find the first occurrence of target in a sorted vector with duplicates.
+ *
+ * @param arr Sorted vector that may contain duplicates
+ * @param target Element to search for
+ * @return Index of first occurrence, notFound if not found
+ */
+std::ptrdiff_t binarySearchFirstOccurrence(const std::vector<int>& arr, int target) {
+    // The first occurrence is the lower bound, if it holds target
+    return binarySearch(arr, target);
+}
+
+/**
+ * Find the last occurrence of target in a sorted vector with duplicates.
+ *
+ * @param arr Sorted vector that may contain duplicates
+ * @param target Element to search for
+ * @return Index of last occurrence, notFound if not found
+ */
+std::ptrdiff_t binarySearchLastOccurrence(const std::vector<int>& arr, int target) {
+    // The last occurrence is just before the upper bound
+    size_t end = upperBoundBranchless(arr.data(), arr.size(), target);
+    if (end > 0 && arr[end - 1] == target) {
+        return static_cast<std::ptrdiff_t>(end - 1);
+    }
+    return notFound;
+}
+
+/**
+ * Fused lower bound of lo and upper bound of hi (lo <= hi).
+ *
+ * Both branchless searches run in one loop with the same halving
+ * schedule. Until their paths split, they probe the same element, so the
+ * shared upper levels cost one cache miss instead of two. After the
+ * split, the two independent probes overlap their misses.
+ *
+ * @param data Pointer to the first element of the sorted range
+ * @param n Number of elements
+ * @param lo Smallest value of interest
+ * @param hi Largest value of interest
+ * @return Index of the first element not less than lo, and of the first
+ *         element greater than hi
+ */
+template<typename T>
+std::pair<size_t, size_t> fusedBounds(const T* data, size_t n, const T& lo, const T& hi) {
+    if (n == 0) {
+        return {0, 0};
+    }
+
+    const T* lower = data;
+    const T* upper = data;
+    while (n > 1) {
+        size_t half = n / 2;
+        lower = (lower[half] < lo) ? lower + half : lower;
+        upper = !(hi < upper[half]) ? upper + half : upper;
+        n -= half;
+    }
+    return {static_cast<size_t>(lower - data) + (*lower < lo),
+            static_cast<size_t>(upper - data) + !(hi < *upper)};
+}
+
+/**
+ * Finds all occurrences of target with one fused search.
+ *
+ * @param arr Sorted vector that may contain duplicates
+ * @param target Element to search for
+ * @return Half-open index range [first, end) of the occurrences, empty
+ *         at the insertion point if target is absent
+ */
+std::pair<size_t, size_t> equalRange(const std::vector<int>& arr, int target) {
+    return fusedBounds(arr.data(), arr.size(), target, target);
+}
+
+/**
+ * Counts the elements within [lo, hi], for range queries.
+ *
+ * @param arr Sorted vector that may contain duplicates
+ * @param lo Smallest value to count
+ * @param hi Largest value to count
+ * @return Number of elements x with lo <= x <= hi (0 if lo > hi)
+ */
+size_t countInRange(const std::vector<int>& arr, int lo, int hi) {
+    if (lo > hi) {
+        return 0;
+    }
+    std::pair<size_t, size_t> bounds = fusedBounds(arr.data(), arr.size(), lo, hi);
+    return bounds.second - bounds.first;
+}
+
+/**
+ * Template version for any comparable type.
+ */
+template<typename T>
+std::ptrdiff_t binarySearchTemplate(const std::vector<T>& arr, const T& target) {
+    size_t index = lowerBoundBranchless(arr.data(), arr.size(), target);
+    if (index < arr.size() && arr[index] == target) {
+        return static_cast<std::ptrdiff_t>(index);
+    }
+    return notFound;
+}
+
+/**
+ * Batched lower bound over one sorted range.
+ *
+ * Independent searches are advanced in lockstep groups: every step
+ * issues the probe of each search in the group before any of them is
+ * needed, and prefetches both possible probes of the following step,
+ * so up to a group's worth of cache misses are in flight at once
+ * instead of one.
+ *
+ * @param data Pointer to the first element of the sorted range
+ * @param n Number of elements
+ * @param targets Keys to search for
+ * @param count Number of keys
+ * @param results Receives, for each key, the index of the first element
+ *                not less than it (n if none)
+ */
+template<typename T>
+void lowerBoundBatch(const T* data, size_t n, const T* targets, size_t count, size_t* results) {
+    constexpr size_t groupSize = 16;
+
+    for (size_t first = 0; first < count; first += groupSize) {
+        size_t group = std::min(groupSize, count - first);
+        const T* base[groupSize];
+        std::fill(base, base + group, data);
+
+        if (n == 0) {
+            std::fill(results + first, results + first + group, size_t{0});
+            continue;
+        }
+
+        for (size_t length = n; length > 1;) {
+            size_t half = length / 2;
+            size_t nextHalf = (length - half) / 2;
+            for (size_t g = 0; g < group; g++) {
+                // Fetch both possible next probes before this comparison resolves;
+                // both lie below base[g] + length, so they stay inside the range
+                __builtin_prefetch(base[g] + nextHalf);
+                __builtin_prefetch(base[g] + half + nextHalf);
+                base[g] = (base[g][half] < targets[first + g]) ? base[g] + half : base[g];
+            }
+            length -= half;
+        }
+        for (size_t g = 0; g < group; g++) {
+            results[first + g] = (base[g] - data) + (*base[g] < targets[first + g]);
+        }
+    }
+}
+
+/**
+ * Looks up many targets at once, with the same result per target as
+ * binarySearch but with their cache misses overlapped.
+ *
+ * @param arr Sorted vector to search in
+ * @param targets Elements to search for
+ * @param count Number of targets
+ * @param results Receives, for each target, its index or notFound if not found
+ */
+void binarySearchBatch(const std::vector<int>& arr, const int* targets, size_t count, std::ptrdiff_t* results) {
+    constexpr size_t chunk = 256;
+    size_t positions[chunk];
+
+    for (size_t first = 0; first < count; first += chunk) {
+        size_t length = std::min(chunk, count - first);
+        lowerBoundBatch(arr.data(), arr.size(), targets + first, length, positions);
+        for (size_t i = 0; i < length; i++) {
+            size_t index = positions[i];
+            bool found = index < arr.size() && arr[index] == targets[first + i];
+            results[first + i] = found ? static_cast<std::ptrdiff_t>(index) : notFound;
+        }
+    }
+}
+
+/**
+ * Galloping (exponential) lower bound starting from a hint.
+ *
+ * Probes at distances 1, 2, 4, ... from the hint towards the target
+ * until the answer is bracketed, then finishes with a branchless search
+ * of the bracket, so the cost is O(log d) for an answer d positions away
+ * instead of O(log n).
+ *
+ * @param data Pointer to the first element of the sorted range
+ * @param n Number of elements
+ * @param target Element to search for
+ * @param hint Position expected to be near the answer (clamped to n)
+ * @return Index of the first element not less than target, n if none
+ */
+template<typename T>
+size_t gallopLowerBound(const T* data, size_t n, const T& target, size_t hint) {
+    hint = std::min(hint, n);
+    size_t lo;
+    size_t hi;
+
+    if (hint < n && data[hint] < target) {
+        // The answer is after the hint: gallop right
+        lo = hint + 1;
+        hi = n;
+        for (size_t step = 1; step < n - hint; step *= 2) {
+            if (!(data[hint + step] < target)) {
+                hi = hint + step;
+                break;
+            }
+            lo = hint + step + 1;
+        }
+    } else {
+        // The answer is at or before the hint: gallop left
+        lo = 0;
+        hi = hint;
+        for (size_t step = 1; step <= hint; step *= 2) {
+            if (data[hint - step] < target) {
+                lo = hint - step + 1;
+                break;
+            }
+            hi = hint - step;
+        }
+    }
+    return lo + lowerBoundBranchless(data + lo, hi - lo, target);
+}
+
+/**
+ * Binary search that starts galloping from a caller-supplied hint, with
+ * the same result as binarySearch.
+ *
+ * @param arr Sorted vector to search in
+ * @param target Element to search for
+ * @param hint Position expected to be near target
+ * @return Index of the first occurrence of target, notFound if not found
+ */
+std::ptrdiff_t binarySearchFromHint(const std::vector<int>& arr, int target, size_t hint) {
+    size_t index = gallopLowerBound(arr.data(), arr.size(), target, hint);
+    if (index < arr.size() && arr[index] == target) {
+        return static_cast<std::ptrdiff_t>(index);
+    }
+    return notFound;
+}
+
+/**
+ * Stateful search over one sorted array that remembers where the last
+ * lookup ended and gallops from there, so a stream of nearby or roughly
+ * ascending queries costs O(log distance) per lookup.
+ * The cursor does not copy the keys; the array must outlive it.
+ */
+template<typename T>
+class SearchCursor {
+private:
+    const T* _data;
+    size_t _size;
+    size_t _position;
+
+public:
+    /**
+     * Creates a cursor at the start of a sorted vector.
+     * @param sorted Keys in ascending order; must outlive the cursor
+     */
+    explicit SearchCursor(const std::vector<T>& sorted)
+        : _data(sorted.data()), _size(sorted.size()), _position(0) {}
+
+    /**
+     * Gets the position where the last lookup ended.
+     * @return The current hint
+     */
+    size_t position() const {
+        return _position;
+    }
+
+    /**
+     * Moves the cursor back to the start.
+     */
+    void reset() {
+        _position = 0;
+    }
+
+    /**
+     * Finds the insertion point of target, like std::lower_bound,
+     * galloping from the previous result.
+     * @param target Key to search for
+     * @return Index of the first key not less than target, the array size if none
+     */
+    size_t lowerBound(const T& target) {
+        _position = gallopLowerBound(_data, _size, target, _position);
+        return _position;
+    }
+
+    /**
+     * Finds target, with the same result as binarySearch.
+     * @param target Key to search for
+     * @return Index of the first occurrence of target, notFound if not found
+     */
+    std::ptrdiff_t find(const T& target) {
+        size_t index = lowerBound(target);
+        return index < _size && _data[index] == target ? static_cast<std::ptrdiff_t>(index) : notFound;
+    }
+};
+
+/**
+ * Strategies for intersecting two sorted sets.
+ */
+enum class SetAlgorithm {
+    Auto,    // Chosen per pair from the size ratio
+    Merge,   // Branchless linear merge, best for similar sizes
+    Gallop,  // Each element of the smaller set gallops through the larger one
+    Simd     // 4x4 block compares with SSE2, falling back to Merge elsewhere
+};
+
+/**
+ * Picks an intersection strategy from the sizes of the two sets: when one
+ * set is much larger, galloping skips most of it; otherwise every element
+ * is visited anyway and block compares do it fastest.
+ *
+ * @param smaller Size of the smaller set
+ * @param larger Size of the larger set
+ * @return The strategy to use
+ */
+SetAlgorithm chooseSetAlgorithm(size_t smaller, size_t larger) {
+    if (larger / 32 >= std::max<size_t>(smaller, 1)) {
+        return SetAlgorithm::Gallop;
+    }
+#ifdef __SSE2__
+    return SetAlgorithm::Simd;
+#else
+    return SetAlgorithm::Merge;
+#endif
+}
+
+/**
+ * Intersects by merging, without data-dependent branches.
+ */
+size_t intersectMerge(const int* a, size_t na, const int* b, size_t nb, int* out) {
+    size_t i = 0;
+    size_t j = 0;
+    size_t count = 0;
+    while (i < na && j < nb) {
+        int x = a[i];
+        int y = b[j];
+        if (out != nullptr) {
+            out[count] = x;
+        }
+        count += x == y;
+        i += x <= y;
+        j += y <= x;
+    }
+    return count;
+}
+
+/**
+ * Intersects by galloping each element of a through b, resuming where
+ * the previous element stopped; a should be the smaller set.
+ */
+size_t intersectGallop(const int* a, size_t na, const int* b, size_t nb, int* out) {
+    size_t position = 0;
+    size_t count = 0;
+    for (size_t i = 0; i < na && position < nb; i++) {
+        position = gallopLowerBound(b, nb, a[i], position);
+        if (position < nb && b[position] == a[i]) {
+            if (out != nullptr) {
+                out[count] = a[i];
+            }
+            count++;
+        }
+    }
+    return count;
+}
+
+/**
+ * Intersects with SSE2 block compares: four elements of a are compared
+ * against all four rotations of a block of b at once, and the block with
+ * the smaller maximum advances. Remaining elements are merged.
+ */
+size_t intersectSimd(const int* a, size_t na, const int* b, size_t nb, int* out) {
+    size_t i = 0;
+    size_t j = 0;
+    size_t count = 0;
+#ifdef __SSE2__
+    while (i + 4 <= na && j + 4 <= nb) {
+        __m128i blockA = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+        __m128i blockB = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + j));
+        __m128i equal = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi32(blockA, blockB),
+                         _mm_cmpeq_epi32(blockA, _mm_shuffle_epi32(blockB, _MM_SHUFFLE(0, 3, 2, 1)))),
+            _mm_or_si128(_mm_cmpeq_epi32(blockA, _mm_shuffle_epi32(blockB, _MM_SHUFFLE(1, 0, 3, 2))),
+                         _mm_cmpeq_epi32(blockA, _mm_shuffle_epi32(blockB, _MM_SHUFFLE(2, 1, 0, 3)))));
+        unsigned mask = _mm_movemask_ps(_mm_castsi128_ps(equal));
+
+        if (out != nullptr) {
+            for (unsigned bits = mask; bits != 0; bits &= bits - 1) {
+                out[count++] = a[i + __builtin_ctz(bits)];
+            }
+        } else {
+            count += __builtin_popcount(mask);
+        }
+
+        int maxA = a[i + 3];
+        int maxB = b[j + 3];
+        i += maxA <= maxB ? 4 : 0;
+        j += maxB <= maxA ? 4 : 0;
+    }
+#endif
+    return count + intersectMerge(a + i, na - i, b + j, nb - j, out == nullptr ? nullptr : out + count);
+}
+
+/**
+ * Checks the precondition shared by the intersection strategies: merge
+ * keeps min(x, y) copies of a repeated value, while gallop and the block
+ * compares do not, so with duplicates the answer would depend on which
+ * strategy Auto picked.
+ */
+bool isStrictlyAscending(const std::vector<int>& set) {
+    return std::adjacent_find(set.begin(), set.end(), std::greater_equal<int>()) == set.end();
+}
+
+/**
+ * Intersects two sorted sets of distinct integers.
+ *
+ * @param a First set, ascending without duplicates
+ * @param na Size of a
+ * @param b Second set, ascending without duplicates
+ * @param nb Size of b
+ * @param out Receives the common elements in ascending order (room for
+ *            min(na, nb)), or nullptr to only count them
+ * @param algorithm Strategy to use
+ * @return Number of common elements
+ */
+size_t intersectSorted(const int* a, size_t na, const int* b, size_t nb, int* out,
+                       SetAlgorithm algorithm = SetAlgorithm::Auto) {
+    if (na > nb) {
+        std::swap(a, b);
+        std::swap(na, nb);
+    }
+    if (algorithm == SetAlgorithm::Auto) {
+        algorithm = chooseSetAlgorithm(na, nb);
+    }
+
+    switch (algorithm) {
+        case SetAlgorithm::Gallop:
+            return intersectGallop(a, na, b, nb, out);
+        case SetAlgorithm::Simd:
+            return intersectSimd(a, na, b, nb, out);
+        default:
+            return intersectMerge(a, na, b, nb, out);
+    }
+}
+
+/**
+ * Intersects two sorted sets (posting lists) of distinct integers.
+ *
+ * @param a First set, ascending without duplicates
+ * @param b Second set, ascending without duplicates
+ * @param algorithm Strategy to use, by default chosen from the size ratio
+ * @return The common elements in ascending order
+ */
+std::vector<int> setIntersection(const std::vector<int>& a, const std::vector<int>& b,
+                                 SetAlgorithm algorithm = SetAlgorithm::Auto) {
+    assert(isStrictlyAscending(a) && isStrictlyAscending(b));
+    std::vector<int> result(std::min(a.size(), b.size()));
+    result.resize(intersectSorted(a.data(), a.size(), b.data(), b.size(), result.data(), algorithm));
+    return result;
+}
+
+/**
+ * Counts the common elements of two sorted sets without materializing them.
+ *
+ * @param a First set, ascending without duplicates
+ * @param b Second set, ascending without duplicates
+ * @param algorithm Strategy to use, by default chosen from the size ratio
+ * @return Size of the intersection
+ */
+size_t setIntersectionCount(const std::vector<int>& a, const std::vector<int>& b,
+                            SetAlgorithm algorithm = SetAlgorithm::Auto) {
+    assert(isStrictlyAscending(a) && isStrictlyAscending(b));
+    return intersectSorted(a.data(), a.size(), b.data(), b.size(), nullptr, algorithm);
+}
+
+/**
+ * Intersects any number of sorted sets, smallest first, so every step
+ * gallops a shrinking candidate list through the next larger set.
+ *
+ * @param lists Sets, each ascending without duplicates
+ * @param countOnly Whether to skip writing the final intersection
+ * @param count Receives the size of the intersection
+ * @return The common elements (empty when countOnly is set)
+ */
+std::vector<int> intersectAll(const std::vector<std::vector<int>>& lists, bool countOnly, size_t& count) {
+    count = 0;
+    if (lists.empty()) {
+        return {};
+    }
+
+    std::vector<const std::vector<int>*> bySize;
+    for (const std::vector<int>& list : lists) {
+        assert(isStrictlyAscending(list));
+        bySize.push_back(&list);
+    }
+    std::sort(bySize.begin(), bySize.end(),
+              [](const std::vector<int>* x, const std::vector<int>* y) { return x->size() < y->size(); });
+
+    std::vector<int> candidates = *bySize[0];
+    for (size_t k = 1; k < bySize.size() && !candidates.empty(); k++) {
+        const std::vector<int>& next = *bySize[k];
+        bool last = k + 1 == bySize.size();
+        if (last && countOnly) {
+            count = intersectSorted(candidates.data(), candidates.size(), next.data(), next.size(), nullptr);
+            return {};
+        }
+        // Intersecting into the candidates' own storage is safe: writes never overtake reads
+        candidates.resize(intersectSorted(candidates.data(), candidates.size(),
+                                          next.data(), next.size(), candidates.data()));
+    }
+    count = candidates.size();
+    if (countOnly) {
+        return {};
+    }
+    return candidates;
+}
+
+/**
+ * Intersects k sorted sets, ordering them by size first.
+ *
+ * @param lists Sets, each ascending without duplicates
+ * @return The elements present in every set, in ascending order
+ */
+std::vector<int> setIntersection(const std::vector<std::vector<int>>& lists) {
+    size_t count;
+    return intersectAll(lists, false, count);
+}
+
+/**
+ * Counts the elements present in all of k sorted sets.
+ *
+ * @param lists Sets, each ascending without duplicates
+ * @return Size of the k-way intersection
+ */
+size_t setIntersectionCount(const std::vector<std::vector<int>>& lists) {
+    size_t count;
+    intersectAll(lists, true, count);
+    return count;
+}
+
+/**
+ * Unites two sorted sets of distinct integers. When one set is much
+ * larger, the runs of it between consecutive elements of the smaller set
+ * are found by galloping and copied in bulk.
+ *
+ * @param a First set, ascending without duplicates
+ * @param b Second set, ascending without duplicates
+ * @return Elements of either set, ascending without duplicates
+ */
+std::vector<int> setUnion(const std::vector<int>& a, const std::vector<int>& b) {
+    const std::vector<int>& small = a.size() <= b.size() ? a : b;
+    const std::vector<int>& large = a.size() <= b.size() ? b : a;
+    std::vector<int> result;
+    result.reserve(a.size() + b.size());
+
+    if (chooseSetAlgorithm(small.size(), large.size()) != SetAlgorithm::Gallop) {
+        std::set_union(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(result));
+        return result;
+    }
+
+    size_t position = 0;
+    for (int value : small) {
+        size_t next = gallopLowerBound(large.data(), large.size(), value, position);
+        result.insert(result.end(), large.begin() + position, large.begin() + next);
+        result.push_back(value);
+        position = next < large.size() && large[next] == value ? next + 1 : next;
+    }
+    result.insert(result.end(), large.begin() + position, large.end());
+    return result;
+}
+
+/**
+ * Computes the elements of a that are not in b, galloping through
+ * whichever set is much larger.
+ *
+ * @param a Set to subtract from, ascending without duplicates
+ * @param b Set to subtract, ascending without duplicates
+ * @return Elements of a missing from b, in ascending order
+ */
+std::vector<int> setDifference(const std::vector<int>& a, const std::vector<int>& b) {
+    std::vector<int> result;
+    if (chooseSetAlgorithm(std::min(a.size(), b.size()), std::max(a.size(), b.size())) != SetAlgorithm::Gallop) {
+        std::set_difference(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(result));
+        return result;
+    }
+
+    size_t position = 0;
+    if (a.size() <= b.size()) {
+        // Few candidates: look each one up in b
+        for (int value : a) {
+            position = gallopLowerBound(b.data(), b.size(), value, position);
+            if (position == b.size() || b[position] != value) {
+                result.push_back(value);
+            }
+        }
+    } else {
+        // Few removals: copy the runs of a between them
+        result.reserve(a.size());
+        for (int value : b) {
+            size_t next = gallopLowerBound(a.data(), a.size(), value, position);
+            result.insert(result.end(), a.begin() + position, a.begin() + next);
+            position = next < a.size() && a[next] == value ? next + 1 : next;
+        }
+        result.insert(result.end(), a.begin() + position, a.end());
+    }
+    return result;
+}
+
+/**
+ * Probe strategies for interpolation-style searches.
+ */
+enum class InterpolationMode {
+    Binary,                   // Plain branchless halving
+    Interpolation,            // Linear interpolation between the range ends
+    InterpolationSequential,  // One interpolation probe, then a short linear scan
+    ThreePoint                // Inverse quadratic interpolation through ends and middle
+};
+
+/**
+ * Gets a printable name of an interpolation mode.
+ */
+const char* interpolationModeName(InterpolationMode mode) {
+    switch (mode) {
+        case InterpolationMode::Binary: return "binary";
+        case InterpolationMode::Interpolation: return "interpolation";
+        case InterpolationMode::InterpolationSequential: return "interpolation-sequential";
+        case InterpolationMode::ThreePoint: return "three-point";
+    }
+    return "unknown";
+}
+
+/**
+ * Converts an estimated position to a probe inside [lo, hi).
+ */
+size_t clampProbe(double position, size_t lo, size_t hi) {
+    if (!(position >= static_cast<double>(lo))) {
+        return lo;  // Also catches NaN from degenerate ranges
+    }
+    if (position >= static_cast<double>(hi - 1)) {
+        return hi - 1;
+    }
+    return static_cast<size_t>(position);
+}
+
+/**
+ * Estimates the position of target in data[lo, hi) by linear
+ * interpolation between the two ends of the range.
+ */
+size_t interpolationProbe(const int* data, size_t lo, size_t hi, int target) {
+    double first = data[lo];
+    double last = data[hi - 1];
+    if (!(last > first)) {
+        return lo;
+    }
+    double position = lo + (target - first) * static_cast<double>(hi - 1 - lo) / (last - first);
+    return clampProbe(position, lo, hi);
+}
+
+/**
+ * Estimates the position of target in data[lo, hi) by inverse quadratic
+ * interpolation through the two ends and the middle of the range, which
+ * follows curved (for example exponential) key distributions better
+ * than a straight line.
+ */
+size_t threePointProbe(const int* data, size_t lo, size_t hi, int target) {
+    size_t mid = lo + (hi - lo) / 2;
+    double x0 = data[lo];
+    double x1 = data[mid];
+    double x2 = data[hi - 1];
+    if (!(x0 < x1 && x1 < x2)) {
+        return interpolationProbe(data, lo, hi, target);
+    }
+
+    double t = target;
+    double position = lo * (t - x1) * (t - x2) / ((x0 - x1) * (x0 - x2))
+                      + mid * (t - x0) * (t - x2) / ((x1 - x0) * (x1 - x2))
+                      + (hi - 1) * (t - x0) * (t - x1) / ((x2 - x0) * (x2 - x1));
+    return clampProbe(position, lo, hi);
+}
+
+/**
+ * Lower bound in data[lo, hi), given that the answer lies in [lo, hi],
+ * driven by an estimating probe.
+ *
+ * A probe only cuts the range on one side, so each one is followed by a
+ * fence about sqrt(range) further towards the target, the typical
+ * estimate error on uniform keys; when the fence brackets the target the
+ * range shrinks to that gap. Whenever a step still fails to halve the
+ * range, as on skewed data, a binary step follows it, so the search
+ * never takes more than a few times the probes of binary search.
+ */
+template<typename Probe>
+size_t guardedLowerBound(const int* data, size_t lo, size_t hi, int target, Probe probe) {
+    while (hi - lo > 16) {
+        size_t before = hi - lo;
+        size_t gap = static_cast<size_t>(std::sqrt(static_cast<double>(before)));
+        size_t position = probe(data, lo, hi, target);
+
+        if (data[position] < target) {
+            lo = position + 1;
+            size_t fence = std::min(position + gap, hi - 1);
+            if (data[fence] < target) {
+                lo = fence + 1;
+            } else {
+                hi = fence;
+            }
+        } else {
+            hi = position;
+            if (position >= lo + gap) {
+                size_t fence = position - gap;
+                if (data[fence] < target) {
+                    lo = fence + 1;
+                } else {
+                    hi = fence;
+                }
+            }
+        }
+
+        if (hi - lo > before / 2) {
+            size_t mid = lo + (hi - lo) / 2;
+            if (data[mid] < target) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+    }
+    return lo + lowerBoundBranchless(data + lo, hi - lo, target);
+}
+
+/**
+ * Interpolation-sequential lower bound: a single interpolation probe,
+ * then a linear scan towards the target. Scans longer than a few cache
+ * lines mean the estimate was poor, so the rest of the range is handed
+ * to guarded interpolation search.
+ */
+size_t interpolationSequentialLowerBound(const int* data, size_t n, int target) {
+    const size_t maxScan = 32;
+    size_t position = interpolationProbe(data, 0, n, target);
+
+    if (data[position] < target) {
+        size_t i = position + 1;
+        for (size_t steps = 0; steps < maxScan; steps++, i++) {
+            if (i == n || !(data[i] < target)) {
+                return i;
+            }
+        }
+        return guardedLowerBound(data, i, n, target, interpolationProbe);
+    }
+
+    size_t i = position;
+    for (size_t steps = 0; steps < maxScan; steps++, i--) {
+        if (i == 0 || data[i - 1] < target) {
+            return i;
+        }
+    }
+    return guardedLowerBound(data, 0, i, target, interpolationProbe);
+}
+
+/**
+ * Lower bound of target in a sorted array with the given probe strategy.
+ *
+ * @param data Pointer to the first element of the sorted array
+ * @param n Number of elements
+ * @param target Element to search for
+ * @param mode Probe strategy
+ * @return Index of the first element not less than target, n if none
+ */
+size_t interpolationLowerBound(const int* data, size_t n, int target, InterpolationMode mode) {
+    if (n == 0) {
+        return 0;
+    }
+    switch (mode) {
+        case InterpolationMode::Interpolation:
+            return guardedLowerBound(data, 0, n, target, interpolationProbe);
+        case InterpolationMode::InterpolationSequential:
+            return interpolationSequentialLowerBound(data, n, target);
+        case InterpolationMode::ThreePoint:
+            return guardedLowerBound(data, 0, n, target, threePointProbe);
+        case InterpolationMode::Binary:
+            break;
+    }
+    return lowerBoundBranchless(data, n, target);
+}
+
+/**
+ * Interpolation search on a sorted vector, with the same result as
+ * binarySearch. Uniformly distributed keys need a handful of probes
+ * where binary search needs log2(n).
+ *
+ * @param arr Sorted vector to search in
+ * @param target Element to search for
+ * @param mode Probe strategy
+ * @return Index of the first occurrence of target, notFound if not found
+ */
+std::ptrdiff_t interpolationSearch(const std::vector<int>& arr, int target,
+                        InterpolationMode mode = InterpolationMode::Interpolation) {
+    size_t index = interpolationLowerBound(arr.data(), arr.size(), target, mode);
+    if (index < arr.size() && arr[index] == target) {
+        return static_cast<std::ptrdiff_t>(index);
+    }
+    return notFound;
+}
+
+/**
+ * Picks a probe strategy for a sorted array by sampling its keys: each
+ * sampled key is located with a single linear and a single three-point
+ * estimate, and the mean distance from its real position decides.
+ *
+ * @param data Pointer to the first element of the sorted array
+ * @param n Number of elements
+ * @return The strategy expected to need the fewest probes
+ */
+InterpolationMode selectInterpolationMode(const int* data, size_t n) {
+    const size_t samples = 64;
+    if (n < 2 * samples) {
+        return InterpolationMode::Binary;
+    }
+
+    double linearError = 0;
+    double threePointError = 0;
+    for (size_t s = 1; s < samples; s++) {
+        size_t position = s * (n - 1) / samples;
+        double linear = static_cast<double>(interpolationProbe(data, 0, n, data[position]));
+        double threePoint = static_cast<double>(threePointProbe(data, 0, n, data[position]));
+        linearError += std::fabs(linear - position) / (samples - 1);
+        threePointError += std::fabs(threePoint - position) / (samples - 1);
+    }
+
+    // Estimates that still leave a large fraction of the array gain nothing
+    if (std::min(linearError, threePointError) > static_cast<double>(n) / 32) {
+        return InterpolationMode::Binary;
+    }
+    // Close enough that a short scan from the first estimate usually finishes
+    if (linearError <= 32) {
+        return InterpolationMode::InterpolationSequential;
+    }
+    return threePointError < linearError / 2 ? InterpolationMode::ThreePoint : InterpolationMode::Interpolation;
+}
+
+/**
+ * Search index that samples the key distribution once, when it is built,
+ * and answers every lookup with the interpolation mode chosen then.
+ * The index does not copy the keys; the array must outlive it.
+ */
+class InterpolationSearchIndex {
+private:
+    const int* _data;
+    size_t _size;
+    InterpolationMode _mode;
+
+public:
+    /**
+     * Builds the index, choosing the mode with selectInterpolationMode.
+     * @param sorted Keys in ascending order; must outlive the index
+     */
+    explicit InterpolationSearchIndex(const std::vector<int>& sorted)
+        : _data(sorted.data()), _size(sorted.size()),
+          _mode(selectInterpolationMode(sorted.data(), sorted.size())) {}
+
+    /**
+     * Builds the index with a fixed mode.
+     * @param sorted Keys in ascending order; must outlive the index
+     * @param mode Probe strategy to use
+     */
+    InterpolationSearchIndex(const std::vector<int>& sorted, InterpolationMode mode)
+        : _data(sorted.data()), _size(sorted.size()), _mode(mode) {}
+
+    /**
+     * Gets the probe strategy in use.
+     * @return The selected mode
+     */
+    InterpolationMode mode() const {
+        return _mode;
+    }
+
+    /**
+     * Finds the insertion point of target, like std::lower_bound.
+     * @param target Key to search for
+     * @return Index of the first key not less than target, the array size if none
+     */
+    size_t lowerBound(int target) const {
+        return interpolationLowerBound(_data, _size, target, _mode);
+    }
+
+    /**
+     * Finds target, with the same result as binarySearch.
+     * @param target Key to search for
+     * @return Index of the first occurrence of target, notFound if not found
+     */
+    std::ptrdiff_t find(int target) const {
+        size_t index = lowerBound(target);
+        return index < _size && _data[index] == target ? static_cast<std::ptrdiff_t>(index) : notFound;
+    }
+};
+
+/**
+ * Allocator returning cache-line-aligned memory, so that a search index
+ * can place groups of nodes exactly on line boundaries.
+ */
+template <typename T>
+struct CacheAlignedAllocator {
+    using value_type = T;
+    static constexpr size_t alignment = 64;
+
+    CacheAlignedAllocator() = default;
+
+    template <typename U>
+    CacheAlignedAllocator(const CacheAlignedAllocator<U>&) {}
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(alignment)));
+    }
+
+    void deallocate(T* p, size_t) {
+        ::operator delete(p, std::align_val_t(alignment));
+    }
+
+    template <typename U>
+    bool operator==(const CacheAlignedAllocator<U>&) const { return true; }
+
+    template <typename U>
+    bool operator!=(const CacheAlignedAllocator<U>&) const { return false; }
+};
+
+/**
+ * Static search index storing a sorted array in Eytzinger (BFS) order:
+ * the root at position 1 and the children of node k at 2k and 2k + 1.
+ *
+ * The first levels of the tree share a few cache lines that stay hot
+ * across lookups, and the 16 descendants of a node four levels down are
+ * contiguous, so each step prefetches them while the current comparison
+ * resolves. The descent itself is branchless. Lookups return the same
+ * indices as the sorted array they were built from.
+ */
+template <typename T>
+class EytzingerIndex {
+private:
+    std::vector<T, CacheAlignedAllocator<T>> _keys;  // _keys[0] is unused padding
+    size_t _size;
+    size_t _leafDepth;   // Depth of the deepest (possibly partial) level
+    size_t _leafCount;   // Nodes present on the deepest level
+
+    /**
+     * Largest power of two number of keys that fits in one cache line.
+     */
+    static constexpr size_t keysPerLine() {
+        size_t keys = 1;
+        while (2 * keys * sizeof(T) <= CacheAlignedAllocator<T>::alignment) {
+            keys *= 2;
+        }
+        return keys;
+    }
+
+    static size_t floorLog2(size_t value) {
+        return 8 * sizeof(unsigned long long) - 1 - __builtin_clzll(value);
+    }
+
+    /**
+     * Sorted-array index of tree node k: its in-order rank in the complete
+     * tree of depth _leafDepth, minus the absent deepest-level nodes that
+     * would precede it.
+     */
+    size_t rank(size_t k) const {
+        size_t depth = floorLog2(k);
+        size_t fullRank = ((2 * (k - (size_t{1} << depth)) + 1) << (_leafDepth - depth)) - 1;
+        size_t leavesBefore = (fullRank + 1) / 2;
+        return fullRank - (leavesBefore > _leafCount ? leavesBefore - _leafCount : 0);
+    }
+
+    /**
+     * Descends to the node holding the first key not less than target.
+     * @return Tree position of that node, 0 if every key is smaller
+     */
+    size_t descend(const T& target) const {
+        const T* keys = _keys.data();
+        size_t k = 1;
+
+        // Every level above the deepest is complete, so the trip count is fixed
+        for (size_t depth = 0; depth < _leafDepth; depth++) {
+            __builtin_prefetch(keys + std::min(k * keysPerLine(), _size));
+            k = 2 * k + (keys[k] < target);
+        }
+
+        // The deepest level may be partial; a missing node counts as a right turn
+        size_t exists = k <= _size;
+        size_t probe = k & (0 - exists);  // k or padding slot 0, without a branch
+        k = 2 * k + ((exists ^ 1) | (keys[probe] < target));
+
+        // Each right turn appended a 1 bit; drop those taken after the last left turn
+        return k >> __builtin_ffsll(static_cast<long long>(~k));
+    }
+
+public:
+    /**
+     * Builds the index from a sorted vector.
+     * @param sorted Keys in ascending order
+     */
+    explicit EytzingerIndex(const std::vector<T>& sorted)
+        : _keys(sorted.size() + 1), _size(sorted.size()), _leafDepth(0), _leafCount(0) {
+        if (_size > 0) {
+            _leafDepth = floorLog2(_size);
+            _leafCount = _size - (size_t{1} << _leafDepth) + 1;
+        }
+        for (size_t k = 1; k <= _size; k++) {
+            _keys[k] = sorted[rank(k)];
+        }
+    }
+
+    /**
+     * Gets the number of keys in the index.
+     * @return The number of keys
+     */
+    size_t size() const {
+        return _size;
+    }
+
+    /**
+     * Finds the insertion point of target, like std::lower_bound.
+     * @param target Key to search for
+     * @return Index of the first key not less than target, size() if none
+     */
+    size_t lowerBound(const T& target) const {
+        size_t k = descend(target);
+        return k == 0 ? _size : rank(k);
+    }
+
+    /**
+     * Finds target, with the same result as binarySearchFirstOccurrence.
+     * @param target Key to search for
+     * @return Index of the first occurrence of target, notFound if not found
+     */
+    std::ptrdiff_t find(const T& target) const {
+        // Both outcomes are computed and selected, so hits and misses do not
+        // cost a misprediction; slot 0 is padding and safe to compare
+        size_t k = descend(target);
+        bool found = (k != 0) & (_keys[k] == target);
+        std::ptrdiff_t index = static_cast<std::ptrdiff_t>(rank(std::max<size_t>(k, 1)));
+        return found ? index : notFound;
+    }
+};
+
+/**
+ * Static B+-tree (S-tree) search index over int keys.
+ *
+ * Every node is one 64-byte cache line of 16 keys. The bottom layer is
+ * the sorted array itself, padded with INT_MAX to whole nodes, and each
+ * layer above holds, for every child but the first, the smallest key of
+ * that child's subtree. A lookup reads one node per layer, about
+ * log17(n) cache lines, and ranks the target inside a node with two
+ * AVX2 compares, a movemask and a popcount. CPUs without AVX2 fall back
+ * to a scalar count of the same node.
+ */
+class STreeIndex {
+private:
+    static constexpr size_t nodeKeys = 16;
+
+    std::vector<int, CacheAlignedAllocator<int>> _keys;  // All layers, leaves first
+    std::vector<size_t> _layerOffsets;                    // Offset of each layer in _keys
+    size_t _size;
+    bool _useAvx2;
+
+    static size_t nodeCount(size_t keys) {
+        return (keys + nodeKeys - 1) / nodeKeys;
+    }
+
+    /**
+     * Number of separator keys in the layer above one holding keys:
+     * one per child beyond the first, rounded up to whole nodes.
+     */
+    static size_t parentKeys(size_t keys) {
+        return (nodeCount(keys) + nodeKeys) / (nodeKeys + 1) * nodeKeys;
+    }
+
+    /**
+     * Counts the keys of a node smaller than target.
+     */
+    static size_t rankInNode(const int* node, int target) {
+        size_t rank = 0;
+        for (size_t i = 0; i < nodeKeys; i++) {
+            rank += node[i] < target;
+        }
+        return rank;
+    }
+
+    size_t descend(int target) const;
+    size_t descendAvx2(int target) const;
+
+public:
+    /**
+     * Builds the index from a sorted vector.
+     * @param sorted Keys in ascending order
+     */
+    explicit STreeIndex(const std::vector<int>& sorted)
+        : _size(sorted.size()), _useAvx2(false) {
+#ifdef BINARY_SEARCH_HAVE_AVX2
+        _useAvx2 = __builtin_cpu_supports("avx2");
+#endif
+        // Layer sizes, from the leaves up to a single root node
+        size_t total = 0;
+        size_t layerKeys = std::max<size_t>(_size, 1);
+        while (true) {
+            _layerOffsets.push_back(total);
+            total += nodeCount(layerKeys) * nodeKeys;
+            if (layerKeys <= nodeKeys) {
+                break;
+            }
+            layerKeys = parentKeys(layerKeys);
+        }
+        _keys.assign(total, INT_MAX);
+        std::copy(sorted.begin(), sorted.end(), _keys.begin());
+
+        for (size_t h = 1; h < _layerOffsets.size(); h++) {
+            size_t layerSize = (h + 1 < _layerOffsets.size() ? _layerOffsets[h + 1] : total)
+                               - _layerOffsets[h];
+            for (size_t i = 0; i < layerSize; i++) {
+                // Child to the right of this separator, then leftmost leaf below it
+                size_t node = i / nodeKeys * (nodeKeys + 1) + i % nodeKeys + 1;
+                for (size_t level = 1; level < h; level++) {
+                    node *= nodeKeys + 1;
+                }
+                if (node * nodeKeys < _size) {
+                    _keys[_layerOffsets[h] + i] = _keys[node * nodeKeys];
+                }
+            }
+        }
+    }
+
+    /**
+     * Gets the number of keys in the index.
+     * @return The number of keys
+     */
+    size_t size() const {
+        return _size;
+    }
+
+    /**
+     * Gets the number of node layers a lookup visits.
+     * @return The height of the tree
+     */
+    size_t height() const {
+        return _layerOffsets.size();
+    }
+
+    /**
+     * Finds the insertion point of target, like std::lower_bound.
+     * @param target Key to search for
+     * @return Index of the first key not less than target, size() if none
+     */
+    size_t lowerBound(int target) const {
+#ifdef BINARY_SEARCH_HAVE_AVX2
+        if (_useAvx2) {
+            return descendAvx2(target);
+        }
+#endif
+        return descend(target);
+    }
+
+    /**
+     * Finds target, with the same result as binarySearch.
+     * @param target Key to search for
+     * @return Index of the first occurrence of target, notFound if not found
+     */
+    std::ptrdiff_t find(int target) const {
+        size_t index = lowerBound(target);
+        return index < _size && _keys[index] == target ? static_cast<std::ptrdiff_t>(index) : notFound;
+    }
+};
+
+#ifdef BINARY_SEARCH_HAVE_AVX2
+/**
+ * Counts the keys of a node smaller than target with AVX2.
+ */
+__attribute__((target("avx2,popcnt")))
+static inline size_t rankInNodeAvx2(const int* node, __m256i target) {
+    __m256i low = _mm256_load_si256(reinterpret_cast<const __m256i*>(node));
+    __m256i high = _mm256_load_si256(reinterpret_cast<const __m256i*>(node + 8));
+    unsigned lowMask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(target, low)));
+    unsigned highMask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(target, high)));
+    return __builtin_popcount(lowMask | highMask << 8);
+}
+
+__attribute__((target("avx2,popcnt")))
+size_t STreeIndex::descendAvx2(int target) const {
+    const int* keys = _keys.data();
+    __m256i broadcast = _mm256_set1_epi32(target);
+    size_t node = 0;
+    for (size_t h = _layerOffsets.size() - 1; h > 0; h--) {
+        size_t child = rankInNodeAvx2(keys + _layerOffsets[h] + node * nodeKeys, broadcast);
+        node = node * (nodeKeys + 1) + child;
+    }
+    return node * nodeKeys + rankInNodeAvx2(keys + node * nodeKeys, broadcast);
+}
+#endif
+
+size_t STreeIndex::descend(int target) const {
+    const int* keys = _keys.data();
+    size_t node = 0;
+    for (size_t h = _layerOffsets.size() - 1; h > 0; h--) {
+        size_t child = rankInNode(keys + _layerOffsets[h] + node * nodeKeys, target);
+        node = node * (nodeKeys + 1) + child;
+    }
+    return node * nodeKeys + rankInNode(keys + node * nodeKeys, target);
+}
+
+/**
+ * Build report of a PgmIndex.
+ */
+struct PgmIndexStats {
+    size_t epsilon;            // Position error bound of the bottom level
+    size_t recursiveEpsilon;   // Error bound of the levels above it
+    size_t levels;             // Number of segment levels
+    size_t segments;           // Segments in the bottom level
+    size_t bytes;              // Memory used by all levels
+    double buildMs;            // Build time in milliseconds
+};
+
+/**
+ * Learned index over a sorted array of integer keys, in the style of the
+ * PGM-index.
+ *
+ * The bottom level is a piecewise linear model of key -> position whose
+ * prediction is within epsilon of the true lower bound for every key.
+ * Each level above models the first keys of the level below in the same
+ * way, with a smaller error bound, until one segment remains. A lookup
+ * evaluates one segment per level and finishes with a branchless search
+ * over about 2 * epsilon elements. On near-uniform keys a few segments
+ * cover millions of keys, so almost every binary search probe is saved.
+ * Larger epsilon means fewer segments and longer last-mile searches.
+ *
+ * The index does not copy the keys; the array must outlive it.
+ */
+template <typename T>
+class PgmIndex {
+    static_assert(std::is_integral<T>::value, "PgmIndex requires integer keys");
+
+private:
+    struct Segment {
+        T key;             // First key the segment covers
+        double slope;      // Positions per key
+        double intercept;  // Exact position of key
+    };
+
+    const T* _data;
+    size_t _size;
+    size_t _epsilon;
+    size_t _recursiveEpsilon;
+    std::vector<std::vector<Segment>> _levels;  // _levels[0] predicts positions in _data
+    PgmIndexStats _stats;
+
+    /**
+     * Signed distance from origin to key. The difference is taken in the
+     * key's own unsigned type before converting to double, so 64-bit keys
+     * beyond 2^53 keep their low bits.
+     */
+    static double keyOffset(T key, T origin) {
+        using U = std::make_unsigned_t<T>;
+        return origin <= key ? static_cast<double>(static_cast<U>(static_cast<U>(key) - static_cast<U>(origin)))
+                             : -static_cast<double>(static_cast<U>(static_cast<U>(origin) - static_cast<U>(key)));
+    }
+
+    /**
+     * Fits segments to the lower-bound function of sorted keys with a
+     * greedy shrinking cone: a segment grows while some slope through
+     * its first point keeps every point within epsilon.
+     *
+     * Besides each distinct key k at its first position, the point
+     * (k + 1, next position) is fitted whenever the next key is larger
+     * than k + 1, so that keys between two stored keys (and past
+     * duplicate runs) are also predicted within epsilon.
+     */
+    static std::vector<Segment> fitSegments(const T* keys, size_t n, size_t epsilon) {
+        std::vector<Segment> segments;
+        bool open = false;
+        T originKey = T();
+        double originPos = 0;
+        double slopeLow = 0;
+        double slopeHigh = 0;
+        double error = static_cast<double>(epsilon);
+
+        auto addPoint = [&](T key, size_t position) {
+            double y = static_cast<double>(position);
+            if (open) {
+                double dx = keyOffset(key, originKey);
+                double low = (y - error - originPos) / dx;
+                double high = (y + error - originPos) / dx;
+                if (low <= slopeHigh && high >= slopeLow) {
+                    slopeLow = std::max(slopeLow, low);
+                    slopeHigh = std::min(slopeHigh, high);
+                    return;
+                }
+                segments.push_back({originKey, (slopeLow + slopeHigh) / 2, originPos});
+            }
+            // Slopes stay non-negative so predictions never decrease within a segment
+            open = true;
+            originKey = key;
+            originPos = y;
+            slopeLow = 0;
+            slopeHigh = std::numeric_limits<double>::infinity();
+        };
+
+        for (size_t i = 0; i < n; i++) {
+            if (i > 0 && keys[i] == keys[i - 1]) {
+                continue;
+            }
+            if (i > 0 && keys[i - 1] + 1 < keys[i]) {
+                addPoint(keys[i - 1] + 1, i);
+            }
+            addPoint(keys[i], i);
+        }
+        if (n > 0 && keys[n - 1] < std::numeric_limits<T>::max()) {
+            addPoint(keys[n - 1] + 1, n);
+        }
+        if (open) {
+            double slope = std::isinf(slopeHigh) ? slopeLow : (slopeLow + slopeHigh) / 2;
+            segments.push_back({originKey, slope, originPos});
+        }
+        return segments;
+    }
+
+    /**
+     * Predicts the lower bound of key among count positions with one
+     * segment, capped by the exact position where the next segment starts.
+     */
+    static size_t predict(const std::vector<Segment>& level, size_t segment, T key, size_t count) {
+        const Segment& s = level[segment];
+        double position = s.intercept + s.slope * keyOffset(key, s.key);
+        if (segment + 1 < level.size()) {
+            position = std::min(position, level[segment + 1].intercept);
+        }
+        position = std::max(0.0, std::min(position, static_cast<double>(count)));
+        return static_cast<size_t>(position);
+    }
+
+    /**
+     * Window of positions around a prediction that holds the true lower
+     * bound, with one extra slot each side for floating-point rounding.
+     */
+    static std::pair<size_t, size_t> window(size_t position, size_t epsilon, size_t count) {
+        size_t low = position > epsilon + 1 ? position - epsilon - 1 : 0;
+        size_t high = std::min(position + epsilon + 2, count);
+        return {low, high};
+    }
+
+public:
+    /**
+     * Builds the index over a sorted vector.
+     * @param sorted Keys in ascending order; must outlive the index
+     * @param epsilon Maximum position error of the bottom level
+     * @param recursiveEpsilon Maximum position error of the upper levels,
+     *        at least 1 so that every level is smaller than the one below
+     */
+    explicit PgmIndex(const std::vector<T>& sorted, size_t epsilon = 64, size_t recursiveEpsilon = 4)
+        : _data(sorted.data()), _size(sorted.size()), _epsilon(epsilon),
+          _recursiveEpsilon(std::max<size_t>(recursiveEpsilon, 1)), _stats() {
+        auto start = std::chrono::high_resolution_clock::now();
+
+        _levels.push_back(fitSegments(_data, _size, _epsilon));
+        while (_levels.back().size() > 1) {
+            std::vector<T> firstKeys;
+            firstKeys.reserve(_levels.back().size());
+            for (const Segment& segment : _levels.back()) {
+                firstKeys.push_back(segment.key);
+            }
+            _levels.push_back(fitSegments(firstKeys.data(), firstKeys.size(), _recursiveEpsilon));
+        }
+
+        auto end = std::chrono::high_resolution_clock::now();
+        _stats.epsilon = _epsilon;
+        _stats.recursiveEpsilon = _recursiveEpsilon;
+        _stats.levels = _levels.size();
+        _stats.segments = _levels[0].size();
+        _stats.bytes = 0;
+        for (const auto& level : _levels) {
+            _stats.bytes += level.size() * sizeof(Segment);
+        }
+        _stats.buildMs = std::chrono::duration<double, std::milli>(end - start).count();
+    }
+
+    /**
+     * Gets the build report: levels, segments, memory and build time.
+     * @return The statistics gathered while building
+     */
+    const PgmIndexStats& stats() const {
+        return _stats;
+    }
+
+    /**
+     * Finds the insertion point of target, like std::lower_bound.
+     * @param target Key to search for
+     * @return Index of the first key not less than target, the array size if none
+     */
+    size_t lowerBound(T target) const {
+        if (_size == 0) {
+            return 0;
+        }
+
+        // Walk down the levels, each one locating the segment to use below it
+        size_t segment = 0;
+        for (size_t level = _levels.size() - 1; level > 0; level--) {
+            const std::vector<Segment>& below = _levels[level - 1];
+            auto range = window(predict(_levels[level], segment, target, below.size()),
+                                _recursiveEpsilon, below.size());
+            size_t next = std::lower_bound(below.begin() + range.first, below.begin() + range.second, target,
+                                           [](const Segment& s, T key) { return s.key < key; })
+                          - below.begin();
+            // The segment to use is the last one starting at or before target
+            segment = next < below.size() && below[next].key == target ? next : (next > 0 ? next - 1 : 0);
+        }
+
+        auto range = window(predict(_levels[0], segment, target, _size), _epsilon, _size);
+        return range.first + lowerBoundBranchless(_data + range.first, range.second - range.first, target);
+    }
+
+    /**
+     * Finds target, with the same result as binarySearch.
+     * @param target Key to search for
+     * @return Index of the first occurrence of target, notFound if not found
+     */
+    std::ptrdiff_t find(T target) const {
+        size_t index = lowerBound(target);
+        return index < _size && _data[index] == target ? static_cast<std::ptrdiff_t>(index) : notFound;
+    }
+};
+
+/**
+ * Fractional cascading over k sorted int arrays.
+ *
+ * Level i merges array i with every second entry of level i + 1, so each
+ * level is at most twice its array's size in total. Every entry records
+ * the lower bound of its key in array i and in level i + 1. One binary
+ * search in level 0 then finds the target's position in every array: at
+ * each further level the recorded bridge is off by at most one entry,
+ * so it costs O(1) instead of another O(log n) search.
+ * The index copies the keys it needs; the arrays may change afterwards,
+ * followed by a call to rebuild.
+ */
+class FractionalCascading {
+private:
+    // 16 bytes, so four entries share a cache line
+    struct Entry {
+        int key;
+        int beforeBridge;     // Key of the next level's entry before the bridge
+        uint32_t position;    // Lower bound of key in this level's array
+        uint32_t bridge;      // Lower bound of key in the next level
+    };
+
+    // Each level ends with a terminal entry for targets above all its keys
+    std::vector<std::vector<Entry>> _levels;
+    std::vector<int> _firstKeys;  // Keys of level 0, for the initial search
+
+    /**
+     * Builds one level from its array and the (already built) next level.
+     */
+    void buildLevel(size_t i, const std::vector<int>& array) {
+        const std::vector<Entry>* next = i + 1 < _levels.size() ? &_levels[i + 1] : nullptr;
+        size_t nextSize = next != nullptr ? next->size() - 1 : 0;
+        if (array.size() + nextSize / 2 >= UINT32_MAX) {
+            throw std::length_error("FractionalCascading levels are limited to 2^32 - 1 entries");
+        }
+        std::vector<Entry>& level = _levels[i];
+        level.clear();
+        level.reserve(array.size() + nextSize / 2 + 1);
+        auto beforeBridge = [next](size_t bridge) { return bridge > 0 ? (*next)[bridge - 1].key : INT_MIN; };
+
+        size_t own = 0;
+        size_t promoted = 1;  // Every second entry of the next level moves up
+        size_t bridge = 0;
+        while (own < array.size() || promoted < nextSize) {
+            // On equal keys the promoted entry goes first, so positions stay lower bounds
+            bool takeOwn = promoted >= nextSize || (own < array.size() && array[own] < (*next)[promoted].key);
+            int key = takeOwn ? array[own] : (*next)[promoted].key;
+            while (bridge < nextSize && (*next)[bridge].key < key) {
+                bridge++;
+            }
+            level.push_back({key, beforeBridge(bridge), static_cast<uint32_t>(own), static_cast<uint32_t>(bridge)});
+            if (takeOwn) {
+                own++;
+            } else {
+                promoted += 2;
+            }
+        }
+        level.push_back({INT_MAX, beforeBridge(nextSize), static_cast<uint32_t>(array.size()),
+                         static_cast<uint32_t>(nextSize)});
+    }
+
+public:
+    FractionalCascading() = default;
+
+    /**
+     * Builds the structure.
+     * @param arrays Arrays, each sorted in ascending order
+     */
+    explicit FractionalCascading(const std::vector<std::vector<int>>& arrays) {
+        rebuild(arrays);
+    }
+
+    /**
+     * Rebuilds every level from the current arrays.
+     * @param arrays Arrays, each sorted in ascending order
+     */
+    void rebuild(const std::vector<std::vector<int>>& arrays) {
+        _levels.assign(arrays.size(), {});
+        rebuild(arrays, arrays.size() - 1);
+    }
+
+    /**
+     * Rebuilds after arrays up to lastChanged changed. A level depends
+     * only on its array and the levels below it, so levels after
+     * lastChanged are kept. A different number of arrays rebuilds all.
+     * @param arrays Arrays, each sorted in ascending order
+     * @param lastChanged Highest index of an array that changed
+     */
+    void rebuild(const std::vector<std::vector<int>>& arrays, size_t lastChanged) {
+        if (arrays.size() != _levels.size()) {
+            rebuild(arrays);
+            return;
+        }
+        if (arrays.empty()) {
+            _firstKeys.clear();
+            return;
+        }
+
+        for (size_t i = std::min(lastChanged, arrays.size() - 1) + 1; i-- > 0;) {
+            buildLevel(i, arrays[i]);
+        }
+        _firstKeys.resize(_levels[0].size() - 1);
+        for (size_t j = 0; j < _firstKeys.size(); j++) {
+            _firstKeys[j] = _levels[0][j].key;
+        }
+    }
+
+    /**
+     * Finds the insertion point of target in every array, like
+     * std::lower_bound on each.
+     * @param target Key to search for
+     * @param positions Receives, per array, the index of its first key not
+     *                  less than target (its size if none)
+     */
+    void lowerBounds(int target, size_t* positions) const {
+        if (_levels.empty()) {
+            return;
+        }
+
+        size_t p = lowerBoundBranchless(_firstKeys.data(), _firstKeys.size(), target);
+        for (size_t i = 0; i + 1 < _levels.size(); i++) {
+            const Entry& entry = _levels[i][p];
+            positions[i] = entry.position;
+            // The lower bound in the next level is the bridge or the entry before it
+            p = entry.bridge - (entry.bridge > 0 && !(entry.beforeBridge < target));
+        }
+        positions[_levels.size() - 1] = _levels.back()[p].position;
+    }
+
+    /**
+     * Finds the insertion point of target in every array.
+     * @param target Key to search for
+     * @return Per array, the index of its first key not less than target
+     */
+    std::vector<size_t> lowerBounds(int target) const {
+        std::vector<size_t> positions(_levels.size());
+        lowerBounds(target, positions.data());
+        return positions;
+    }
+
+    /**
+     * Gets the number of arrays.
+     * @return Number of arrays indexed
+     */
+    size_t arrayCount() const {
+        return _levels.size();
+    }
+
+    /**
+     * Gets the number of entries over all levels.
+     * @return Total entries, at most twice the number of keys plus one per array
+     */
+    size_t entryCount() const {
+        size_t total = 0;
+        for (const std::vector<Entry>& level : _levels) {
+            total += level.size();
+        }
+        return total;
+    }
+};
+
+/**
+ * B+-tree over ordered keys, for data that changes between lookups.
+ *
+ * Leaves hold up to 128 sorted keys in one contiguous array and are
+ * chained for ordered iteration; inner nodes route with up to 63
+ * separator keys. Inside a node, lookups use the branchless lower bound
+ * over the keys. Insert, erase and lowerBound take O(log n) node visits,
+ * each searching one contiguous array. Duplicate keys are kept, like a
+ * std::multiset: keys in child i are not greater than separator i, and
+ * keys in child i + 1 are not less than it. Nodes stay at least half
+ * full, except the root.
+ */
+template <typename T>
+class BPlusTree {
+private:
+    static constexpr size_t leafCapacity = 128;
+    static constexpr size_t innerCapacity = 64;  // Children per inner node
+
+    struct Node {
+        bool leaf;
+        size_t count;  // Keys in a leaf, children in an inner node
+    };
+
+    struct Leaf : Node {
+        T keys[leafCapacity];
+        Leaf* next;
+    };
+
+    struct Inner : Node {
+        T keys[innerCapacity - 1];  // keys[i] separates children[i] and children[i + 1]
+        Node* children[innerCapacity];
+    };
+
+    struct Split {
+        Node* right;  // New right sibling, or nullptr
+        T separator;
+    };
+
+    Node* _root;
+    size_t _size;
+
+    static Leaf* newLeaf() {
+        Leaf* leaf = new Leaf();
+        leaf->leaf = true;
+        leaf->count = 0;
+        leaf->next = nullptr;
+        return leaf;
+    }
+
+    static Inner* newInner() {
+        Inner* inner = new Inner();
+        inner->leaf = false;
+        inner->count = 0;
+        return inner;
+    }
+
+    static void destroy(Node* node) {
+        if (node->leaf) {
+            delete static_cast<Leaf*>(node);
+            return;
+        }
+        Inner* inner = static_cast<Inner*>(node);
+        for (size_t i = 0; i < inner->count; i++) {
+            destroy(inner->children[i]);
+        }
+        delete inner;
+    }
+
+    /**
+     * Child of an inner node to descend into: the first whose separator
+     * is not less than key.
+     */
+    static size_t route(const Inner* inner, const T& key) {
+        return lowerBoundBranchless(inner->keys, inner->count - 1, key);
+    }
+
+    static Split insertInto(Node* node, const T& key) {
+        if (node->leaf) {
+            Leaf* leaf = static_cast<Leaf*>(node);
+            size_t position = upperBoundBranchless(leaf->keys, leaf->count, key);
+            if (leaf->count < leafCapacity) {
+                std::copy_backward(leaf->keys + position, leaf->keys + leaf->count, leaf->keys + leaf->count + 1);
+                leaf->keys[position] = key;
+                leaf->count++;
+                return {nullptr, T()};
+            }
+
+            // Split the full leaf in half, then insert into the proper half
+            Leaf* right = newLeaf();
+            size_t half = leafCapacity / 2;
+            std::copy(leaf->keys + half, leaf->keys + leafCapacity, right->keys);
+            right->count = leafCapacity - half;
+            leaf->count = half;
+            right->next = leaf->next;
+            leaf->next = right;
+
+            Leaf* target = position <= half ? leaf : right;
+            size_t offset = position <= half ? position : position - half;
+            std::copy_backward(target->keys + offset, target->keys + target->count,
+                               target->keys + target->count + 1);
+            target->keys[offset] = key;
+            target->count++;
+            return {right, right->keys[0]};
+        }
+
+        Inner* inner = static_cast<Inner*>(node);
+        size_t i = route(inner, key);
+        Split split = insertInto(inner->children[i], key);
+        if (split.right == nullptr) {
+            return split;
+        }
+
+        // Insert the new child after children[i], in a scratch copy if it overflows
+        T keys[innerCapacity];
+        Node* children[innerCapacity + 1];
+        std::copy(inner->keys, inner->keys + i, keys);
+        keys[i] = split.separator;
+        std::copy(inner->keys + i, inner->keys + inner->count - 1, keys + i + 1);
+        std::copy(inner->children, inner->children + i + 1, children);
+        children[i + 1] = split.right;
+        std::copy(inner->children + i + 1, inner->children + inner->count, children + i + 2);
+        size_t count = inner->count + 1;
+
+        if (count <= innerCapacity) {
+            std::copy(keys, keys + count - 1, inner->keys);
+            std::copy(children, children + count, inner->children);
+            inner->count = count;
+            return {nullptr, T()};
+        }
+
+        // The left half keeps its children; the middle separator moves up
+        Inner* right = newInner();
+        size_t half = count / 2;
+        std::copy(keys, keys + half - 1, inner->keys);
+        std::copy(children, children + half, inner->children);
+        inner->count = half;
+        std::copy(keys + half, keys + count - 1, right->keys);
+        std::copy(children + half, children + count, right->children);
+        right->count = count - half;
+        return {right, keys[half - 1]};
+    }
+
+    /**
+     * Restores the minimum occupancy of parent->children[i] after an
+     * erase, by borrowing from a sibling or merging with one.
+     */
+    static void rebalance(Inner* parent, size_t i) {
+        Node* child = parent->children[i];
+        size_t minimum = child->leaf ? leafCapacity / 2 : innerCapacity / 2;
+        if (child->count >= minimum) {
+            return;
+        }
+
+        Node* left = i > 0 ? parent->children[i - 1] : nullptr;
+        Node* right = i + 1 < parent->count ? parent->children[i + 1] : nullptr;
+
+        if (child->leaf) {
+            Leaf* leaf = static_cast<Leaf*>(child);
+            if (left != nullptr && left->count > minimum) {
+                Leaf* from = static_cast<Leaf*>(left);
+                std::copy_backward(leaf->keys, leaf->keys + leaf->count, leaf->keys + leaf->count + 1);
+                leaf->keys[0] = from->keys[--from->count];
+                leaf->count++;
+                parent->keys[i - 1] = leaf->keys[0];
+            } else if (right != nullptr && right->count > minimum) {
+                Leaf* from = static_cast<Leaf*>(right);
+                leaf->keys[leaf->count++] = from->keys[0];
+                std::copy(from->keys + 1, from->keys + from->count, from->keys);
+                from->count--;
+                parent->keys[i] = from->keys[0];
+            } else if (left != nullptr || right != nullptr) {
+                // Merge the right one of the pair into the left one
+                size_t j = left != nullptr ? i - 1 : i;
+                Leaf* into = static_cast<Leaf*>(parent->children[j]);
+                Leaf* from = static_cast<Leaf*>(parent->children[j + 1]);
+                std::copy(from->keys, from->keys + from->count, into->keys + into->count);
+                into->count += from->count;
+                into->next = from->next;
+                delete from;
+                removeChild(parent, j);
+            }
+            return;
+        }
+
+        Inner* inner = static_cast<Inner*>(child);
+        if (left != nullptr && left->count > minimum) {
+            Inner* from = static_cast<Inner*>(left);
+            std::copy_backward(inner->keys, inner->keys + inner->count - 1, inner->keys + inner->count);
+            std::copy_backward(inner->children, inner->children + inner->count, inner->children + inner->count + 1);
+            inner->keys[0] = parent->keys[i - 1];
+            inner->children[0] = from->children[from->count - 1];
+            inner->count++;
+            parent->keys[i - 1] = from->keys[from->count - 2];
+            from->count--;
+        } else if (right != nullptr && right->count > minimum) {
+            Inner* from = static_cast<Inner*>(right);
+            inner->keys[inner->count - 1] = parent->keys[i];
+            inner->children[inner->count] = from->children[0];
+            inner->count++;
+            parent->keys[i] = from->keys[0];
+            std::copy(from->keys + 1, from->keys + from->count - 1, from->keys);
+            std::copy(from->children + 1, from->children + from->count, from->children);
+            from->count--;
+        } else if (left != nullptr || right != nullptr) {
+            size_t j = left != nullptr ? i - 1 : i;
+            Inner* into = static_cast<Inner*>(parent->children[j]);
+            Inner* from = static_cast<Inner*>(parent->children[j + 1]);
+            into->keys[into->count - 1] = parent->keys[j];
+            std::copy(from->keys, from->keys + from->count - 1, into->keys + into->count);
+            std::copy(from->children, from->children + from->count, into->children + into->count);
+            into->count += from->count;
+            delete from;
+            removeChild(parent, j);
+        }
+    }
+
+    /**
+     * Removes separator j and child j + 1 of an inner node.
+     */
+    static void removeChild(Inner* parent, size_t j) {
+        std::copy(parent->keys + j + 1, parent->keys + parent->count - 1, parent->keys + j);
+        std::copy(parent->children + j + 2, parent->children + parent->count, parent->children + j + 1);
+        parent->count--;
+    }
+
+    static bool eraseFrom(Node* node, const T& key) {
+        if (node->leaf) {
+            Leaf* leaf = static_cast<Leaf*>(node);
+            size_t position = lowerBoundBranchless(leaf->keys, leaf->count, key);
+            if (position == leaf->count || key < leaf->keys[position]) {
+                return false;
+            }
+            std::copy(leaf->keys + position + 1, leaf->keys + leaf->count, leaf->keys + position);
+            leaf->count--;
+            return true;
+        }
+
+        // Copies of a separator key may sit on both sides of it
+        Inner* inner = static_cast<Inner*>(node);
+        for (size_t i = route(inner, key); i < inner->count; i++) {
+            if (eraseFrom(inner->children[i], key)) {
+                rebalance(inner, i);
+                return true;
+            }
+            if (i + 1 == inner->count || key < inner->keys[i]) {
+                break;
+            }
+        }
+        return false;
+    }
+
+public:
+    /**
+     * Forward iterator over the keys in ascending order.
+     */
+    class ConstIterator {
+    private:
+        const Leaf* _leaf;
+        size_t _index;
+
+        void skipEmpty() {
+            while (_leaf != nullptr && _index == _leaf->count) {
+                _leaf = _leaf->next;
+                _index = 0;
+            }
+        }
+
+        friend class BPlusTree;
+
+        ConstIterator(const Leaf* leaf, size_t index) : _leaf(leaf), _index(index) {
+            skipEmpty();
+        }
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+
+        const T& operator*() const {
+            return _leaf->keys[_index];
+        }
+
+        ConstIterator& operator++() {
+            _index++;
+            skipEmpty();
+            return *this;
+        }
+
+        ConstIterator operator++(int) {
+            ConstIterator previous = *this;
+            ++*this;
+            return previous;
+        }
+
+        bool operator==(const ConstIterator& other) const {
+            return _leaf == other._leaf && _index == other._index;
+        }
+
+        bool operator!=(const ConstIterator& other) const {
+            return !(*this == other);
+        }
+    };
+
+    BPlusTree() : _root(newLeaf()), _size(0) {}
+
+    /**
+     * Builds the tree from sorted keys.
+     * @param sorted Keys in ascending order
+     */
+    explicit BPlusTree(const std::vector<T>& sorted) : BPlusTree() {
+        bulkLoad(sorted.data(), sorted.size());
+    }
+
+    BPlusTree(const BPlusTree&) = delete;
+    BPlusTree& operator=(const BPlusTree&) = delete;
+
+    ~BPlusTree() {
+        destroy(_root);
+    }
+
+    /**
+     * Replaces the contents with sorted keys in O(n), building full-width
+     * levels bottom-up instead of inserting one key at a time.
+     * @param sorted Keys in ascending order
+     * @param n Number of keys
+     */
+    void bulkLoad(const T* sorted, size_t n) {
+        destroy(_root);
+        _size = n;
+        if (n == 0) {
+            _root = newLeaf();
+            return;
+        }
+
+        // Spread keys evenly so that every node is at least half full
+        std::vector<Node*> level;
+        std::vector<T> firstKeys;
+        size_t leaves = (n + leafCapacity - 1) / leafCapacity;
+        Leaf* previous = nullptr;
+        for (size_t l = 0, begin = 0; l < leaves; l++) {
+            size_t end = n * (l + 1) / leaves;
+            Leaf* leaf = newLeaf();
+            std::copy(sorted + begin, sorted + end, leaf->keys);
+            leaf->count = end - begin;
+            if (previous != nullptr) {
+                previous->next = leaf;
+            }
+            previous = leaf;
+            level.push_back(leaf);
+            firstKeys.push_back(sorted[begin]);
+            begin = end;
+        }
+
+        while (level.size() > 1) {
+            std::vector<Node*> parents;
+            std::vector<T> parentKeys;
+            size_t groups = (level.size() + innerCapacity - 1) / innerCapacity;
+            for (size_t g = 0, begin = 0; g < groups; g++) {
+                size_t end = level.size() * (g + 1) / groups;
+                Inner* inner = newInner();
+                std::copy(level.begin() + begin, level.begin() + end, inner->children);
+                std::copy(firstKeys.begin() + begin + 1, firstKeys.begin() + end, inner->keys);
+                inner->count = end - begin;
+                parents.push_back(inner);
+                parentKeys.push_back(firstKeys[begin]);
+                begin = end;
+            }
+            level.swap(parents);
+            firstKeys.swap(parentKeys);
+        }
+        _root = level[0];
+    }
+
+    /**
+     * Merges a sorted batch into the tree. Small batches are inserted key
+     * by key; once a batch is a sizeable fraction of the tree, both are
+     * merged linearly and bulk-loaded.
+     * @param sorted Keys in ascending order
+     */
+    void merge(const std::vector<T>& sorted) {
+        if (sorted.size() * 16 < _size) {
+            for (const T& key : sorted) {
+                insert(key);
+            }
+            return;
+        }
+
+        std::vector<T> merged;
+        merged.reserve(_size + sorted.size());
+        std::merge(begin(), end(), sorted.begin(), sorted.end(), std::back_inserter(merged));
+        bulkLoad(merged.data(), merged.size());
+    }
+
+    /**
+     * Inserts a key; equal keys are kept side by side.
+     * @param key Key to insert
+     */
+    void insert(const T& key) {
+        Split split = insertInto(_root, key);
+        if (split.right != nullptr) {
+            Inner* root = newInner();
+            root->children[0] = _root;
+            root->children[1] = split.right;
+            root->keys[0] = split.separator;
+            root->count = 2;
+            _root = root;
+        }
+        _size++;
+    }
+
+    /**
+     * Removes one occurrence of a key.
+     * @param key Key to remove
+     * @return Whether the key was present
+     */
+    bool erase(const T& key) {
+        if (!eraseFrom(_root, key)) {
+            return false;
+        }
+        if (!_root->leaf && _root->count == 1) {
+            Inner* root = static_cast<Inner*>(_root);
+            _root = root->children[0];
+            delete root;
+        }
+        _size--;
+        return true;
+    }
+
+    /**
+     * Finds the first key not less than key, like std::lower_bound.
+     * @param key Key to search for
+     * @return Iterator to that key, or end() if there is none
+     */
+    ConstIterator lowerBound(const T& key) const {
+        const Node* node = _root;
+        while (!node->leaf) {
+            const Inner* inner = static_cast<const Inner*>(node);
+            node = inner->children[route(inner, key)];
+        }
+        const Leaf* leaf = static_cast<const Leaf*>(node);
+        return ConstIterator(leaf, lowerBoundBranchless(leaf->keys, leaf->count, key));
+    }
+
+    /**
+     * Checks whether a key is present.
+     * @param key Key to search for
+     * @return Whether some stored key equals key
+     */
+    bool contains(const T& key) const {
+        ConstIterator it = lowerBound(key);
+        return it != end() && !(key < *it);
+    }
+
+    ConstIterator begin() const {
+        const Node* node = _root;
+        while (!node->leaf) {
+            node = static_cast<const Inner*>(node)->children[0];
+        }
+        return ConstIterator(static_cast<const Leaf*>(node), 0);
+    }
+
+    ConstIterator end() const {
+        return ConstIterator(nullptr, 0);
+    }
+
+    /**
+     * Gets the number of keys.
+     * @return Number of keys stored
+     */
+    size_t size() const {
+        return _size;
+    }
+
+    /**
+     * Gets the number of levels.
+     * @return 1 for a single leaf, more as the tree grows
+     */
+    size_t height() const {
+        size_t levels = 1;
+        for (const Node* node = _root; !node->leaf; node = static_cast<const Inner*>(node)->children[0]) {
+            levels++;
+        }
+        return levels;
+    }
+};
+
+/**
+ * Compact sorted string dictionary with front coding.
+ *
+ * Strings are grouped in buckets of 16 in one contiguous buffer. The
+ * first string of each bucket is stored whole. Each of the other 15
+ * stores only the length of the prefix it shares with the previous
+ * string, plus the rest of its bytes. Lengths are varints. A lookup
+ * binary-searches the bucket headers, then decodes one bucket
+ * sequentially. Sorted keys such as URLs share long prefixes, so this
+ * takes a fraction of the memory of a std::vector<std::string>. Strings
+ * are identified by their rank in sorted order.
+ */
+class FrontCodedDictionary {
+private:
+    static constexpr size_t bucketSize = 16;
+
+    std::vector<char> _data;
+    std::vector<size_t> _bucketOffsets;  // Offset of each bucket's header in _data
+    size_t _size = 0;
+
+    static void writeVarint(std::vector<char>& out, size_t value) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<char>(value));
+    }
+
+    static size_t readVarint(const char*& in) {
+        size_t value = 0;
+        for (int shift = 0;; shift += 7) {
+            unsigned char byte = static_cast<unsigned char>(*in++);
+            value |= static_cast<size_t>(byte & 0x7F) << shift;
+            if (byte < 0x80) {
+                return value;
+            }
+        }
+    }
+
+    std::string_view header(size_t bucket) const {
+        const char* in = _data.data() + _bucketOffsets[bucket];
+        size_t length = readVarint(in);
+        return std::string_view(in, length);
+    }
+
+    /**
+     * Decodes the next string of a bucket into current, which holds the
+     * previous one, and advances the read position past it.
+     */
+    static void decodeNext(const char*& in, std::string& current) {
+        size_t shared = readVarint(in);
+        size_t rest = readVarint(in);
+        current.resize(shared);
+        current.append(in, rest);
+        in += rest;
+    }
+
+    /**
+     * Rank of the first string for which before(string) is false, where
+     * before holds for a prefix of the sorted strings. If atPoint is given
+     * and that rank is less than size(), it receives the string there,
+     * already decoded by the scan.
+     */
+    template <typename Before>
+    size_t partitionPoint(Before before, std::string* atPoint = nullptr) const {
+        // Buckets whose header comes before: the answer lies after all of them
+        size_t lo = 0;
+        size_t hi = _bucketOffsets.size();
+        while (lo < hi) {
+            size_t mid = lo + (hi - lo) / 2;
+            if (before(header(mid))) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        if (lo > 0) {
+            size_t bucket = lo - 1;
+            size_t first = bucket * bucketSize;
+            size_t count = std::min(bucketSize, _size - first);
+            const char* in = _data.data() + _bucketOffsets[bucket];
+            size_t length = readVarint(in);
+            std::string current(in, length);
+            in += length;
+            for (size_t i = 1; i < count; i++) {
+                decodeNext(in, current);
+                if (!before(current)) {
+                    if (atPoint != nullptr) {
+                        *atPoint = std::move(current);
+                    }
+                    return first + i;
+                }
+            }
+        }
+
+        // Every string of the earlier buckets comes before: the point is the
+        // header of bucket lo, or the end
+        if (atPoint != nullptr && lo < _bucketOffsets.size()) {
+            *atPoint = std::string(header(lo));
+        }
+        return std::min(lo * bucketSize, _size);
+    }
+
+public:
+    FrontCodedDictionary() = default;
+
+    /**
+     * Builds the dictionary.
+     * @param sorted Strings in ascending order; duplicates are stored once
+     */
+    explicit FrontCodedDictionary(const std::vector<std::string>& sorted) {
+        const std::string* previous = nullptr;
+        for (const std::string& value : sorted) {
+            if (previous != nullptr && value == *previous) {
+                continue;
+            }
+            if (_size % bucketSize == 0) {
+                _bucketOffsets.push_back(_data.size());
+                writeVarint(_data, value.size());
+                _data.insert(_data.end(), value.begin(), value.end());
+            } else {
+                size_t shared = 0;
+                size_t limit = std::min(value.size(), previous->size());
+                while (shared < limit && value[shared] == (*previous)[shared]) {
+                    shared++;
+                }
+                writeVarint(_data, shared);
+                writeVarint(_data, value.size() - shared);
+                _data.insert(_data.end(), value.begin() + shared, value.end());
+            }
+            previous = &value;
+            _size++;
+        }
+        _data.shrink_to_fit();
+    }
+
+    /**
+     * Counts the strings less than value, like std::lower_bound.
+     * @param value String to rank
+     * @return Number of stored strings that compare less than value
+     */
+    size_t rank(std::string_view value) const {
+        return partitionPoint([value](std::string_view s) { return s < value; });
+    }
+
+    /**
+     * Finds a string.
+     * @param value String to search for
+     * @return Its rank, notFound if it is not stored
+     */
+    std::ptrdiff_t find(std::string_view value) const {
+        std::string atRank;
+        size_t index = partitionPoint([value](std::string_view s) { return s < value; }, &atRank);
+        return index < _size && atRank == value ? static_cast<std::ptrdiff_t>(index) : notFound;
+    }
+
+    /**
+     * Decodes the string of a given rank.
+     * @param index Rank, less than size()
+     * @return The string
+     */
+    std::string select(size_t index) const {
+        const char* in = _data.data() + _bucketOffsets[index / bucketSize];
+        size_t length = readVarint(in);
+        std::string current(in, length);
+        in += length;
+        for (size_t i = index % bucketSize; i > 0; i--) {
+            decodeNext(in, current);
+        }
+        return current;
+    }
+
+    /**
+     * Finds all strings starting with a prefix; they are contiguous in
+     * sorted order.
+     * @param prefix Prefix to match
+     * @return Half-open rank range [first, end) of the matching strings
+     */
+    std::pair<size_t, size_t> prefixRange(std::string_view prefix) const {
+        size_t first = rank(prefix);
+        size_t end = partitionPoint([prefix](std::string_view s) {
+            return s.substr(0, prefix.size()) <= prefix;
+        });
+        return {first, end};
+    }
+
+    /**
+     * Gets the number of strings.
+     * @return Number of distinct strings stored
+     */
+    size_t size() const {
+        return _size;
+    }
+
+    /**
+     * Gets the memory used by the encoded strings and bucket offsets.
+     * @return Size in bytes
+     */
+    size_t bytes() const {
+        return _data.size() + _bucketOffsets.size() * sizeof(size_t);
+    }
+};
+
+/**
+ * Blocked Bloom filter over int keys.
+ *
+ * Each key hashes to one 64-byte block, and all of its bits are set in
+ * that block, so any query reads a single cache line. A key that was
+ * added always passes, and other keys pass with about the configured
+ * false-positive rate.
+ */
+class BlockedBloomFilter {
+private:
+    struct alignas(64) Block {
+        uint64_t words[8];
+    };
+
+    std::vector<Block, CacheAlignedAllocator<Block>> _blocks;
+    size_t _hashes;
+
+    static uint64_t hash(int key) {
+        // splitmix64 finalizer
+        uint64_t x = static_cast<uint64_t>(static_cast<uint32_t>(key)) + 0x9E3779B97F4A7C15ull;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+        return x ^ (x >> 31);
+    }
+
+    const Block& blockOf(uint64_t h) const {
+        // Maps the high 32 bits onto [0, block count) without a division
+        return _blocks[((h >> 32) * _blocks.size()) >> 32];
+    }
+
+public:
+    /**
+     * Builds the filter.
+     * @param keys Keys to add
+     * @param n Number of keys
+     * @param falsePositiveRate Target probability that an absent key passes, in (0, 1)
+     */
+    BlockedBloomFilter(const int* keys, size_t n, double falsePositiveRate) {
+        // Set k = log2(1 / rate) bits per key in k / ln 2 bits of space per key, as in a
+        // classic Bloom filter, plus 5% per hash for uneven loads across blocks
+        _hashes = 1;
+        for (double rate = 0.5; rate > falsePositiveRate && _hashes < 16; rate /= 2) {
+            _hashes++;
+        }
+        double k = static_cast<double>(_hashes);
+        double bitsPerKey = (1 + 0.05 * k) * k / 0.6931471805599453;
+        size_t blocks = static_cast<size_t>(static_cast<double>(n) * bitsPerKey / 512) + 1;
+        _blocks.assign(blocks, Block{});
+
+        for (size_t i = 0; i < n; i++) {
+            uint64_t h = hash(keys[i]);
+            Block& block = _blocks[((h >> 32) * _blocks.size()) >> 32];
+            uint32_t position = static_cast<uint32_t>(h);
+            uint32_t step = static_cast<uint32_t>(h >> 9) | 1;
+            for (size_t j = 0; j < _hashes; j++, position += step) {
+                block.words[(position >> 6) & 7] |= uint64_t{1} << (position & 63);
+            }
+        }
+    }
+
+    /**
+     * Checks whether a key may have been added.
+     * @param key Key to check
+     * @return false only if the key was definitely not added
+     */
+    bool mayContain(int key) const {
+        uint64_t h = hash(key);
+        const Block& block = blockOf(h);
+        uint32_t position = static_cast<uint32_t>(h);
+        uint32_t step = static_cast<uint32_t>(h >> 9) | 1;
+        uint64_t missing = 0;
+        for (size_t j = 0; j < _hashes; j++, position += step) {
+            missing |= ~block.words[(position >> 6) & 7] & (uint64_t{1} << (position & 63));
+        }
+        return missing == 0;
+    }
+
+    /**
+     * Gets the memory used by the bit array.
+     * @return Size in bytes
+     */
+    size_t bytes() const {
+        return _blocks.size() * sizeof(Block);
+    }
+};
+
+/**
+ * Outcome counts of the lookups made through a FilteredSearchIndex.
+ */
+struct FilterCounters {
+    size_t hits = 0;            // Present keys
+    size_t definiteMisses = 0;  // Absent keys rejected by the filter alone
+    size_t falsePositives = 0;  // Absent keys that passed the filter and needed a search
+};
+
+/**
+ * Sorted array fronted by a blocked Bloom filter, for workloads where
+ * most lookups miss. A definite miss costs one cache line instead of a
+ * full binary search; keys that pass the filter are searched as usual.
+ * The array is not copied and must outlive the index.
+ */
+class FilteredSearchIndex {
+private:
+    const int* _data;
+    size_t _size;
+    BlockedBloomFilter _filter;
+    FilterCounters _counters;
+
+public:
+    /**
+     * Builds the filter over the array.
+     * @param sorted Keys in ascending order; must outlive the index
+     * @param falsePositiveRate Share of absent keys that may still need a search
+     */
+    explicit FilteredSearchIndex(const std::vector<int>& sorted, double falsePositiveRate = 0.01)
+        : _data(sorted.data()), _size(sorted.size()),
+          _filter(sorted.data(), sorted.size(), falsePositiveRate) {}
+
+    /**
+     * Finds target, with the same result as binarySearch.
+     * @param target Key to search for
+     * @return Index of the first occurrence of target, notFound if not found
+     */
+    std::ptrdiff_t find(int target) {
+        if (!_filter.mayContain(target)) {
+            _counters.definiteMisses++;
+            return notFound;
+        }
+        std::ptrdiff_t index = binarySearch(_data, _size, target);
+        if (index == notFound) {
+            _counters.falsePositives++;
+        } else {
+            _counters.hits++;
+        }
+        return index;
+    }
+
+    /**
+     * Gets the lookup outcome counts since construction or the last reset.
+     * @return The counters
+     */
+    const FilterCounters& counters() const {
+        return _counters;
+    }
+
+    void resetCounters() {
+        _counters = FilterCounters();
+    }
+
+    /**
+     * Gets the memory used by the filter.
+     * @return Size in bytes
+     */
+    size_t filterBytes() const {
+        return _filter.bytes();
+    }
+};
+
+// Test function
+void printVector(const std::vector<int>& vec) {
+    std::cout << "[";
+    for (size_t i = 0; i < vec.size(); ++i) {
+        std::cout << vec[i];
+        if (i < vec.size() - 1) std::cout << ", ";
+    }
+    std::cout << "]";
+}
+
+/**
+ * Test function for the branchless bound kernels behind binarySearch,
+ * binarySearchFirstOccurrence and binarySearchLastOccurrence.
+ */
+void testBranchlessBounds() {
+    std::cout << "\n=== Branchless Bounds ===" << std::endl;
+
+    std::mt19937 rng(37);
+    bool allMatch = true;
+    for (size_t n = 0; n <= 200; n++) {
+        std::uniform_int_distribution<int> dist(0, static_cast<int>(n / 2));
+        std::vector<int> sorted(n);
+        for (int& value : sorted) {
+            value = dist(rng);
+        }
+        std::sort(sorted.begin(), sorted.end());
+
+        for (int target = -1; target <= static_cast<int>(n / 2) + 1; target++) {
+            auto range = std::equal_range(sorted.begin(), sorted.end(), target);
+            int first = range.first == range.second ? -1 : static_cast<int>(range.first - sorted.begin());
+            int last = range.first == range.second ? -1 : static_cast<int>(range.second - sorted.begin()) - 1;
+            allMatch = allMatch
+                       && lowerBoundBranchless(sorted.data(), n, target) == static_cast<size_t>(range.first - sorted.begin())
+                       && upperBoundBranchless(sorted.data(), n, target) == static_cast<size_t>(range.second - sorted.begin())
+                       && binarySearch(sorted, target) == first
+                       && binarySearchFirstOccurrence(sorted, target) == first
+                       && binarySearchLastOccurrence(sorted, target) == last;
+        }
+    }
+    std::cout << "Random arrays with duplicates match std::equal_range: "
+              << (allMatch ? "yes" : "no") << std::endl;
+}
+
+/**
+ * Test function for EytzingerIndex against std::lower_bound and
+ * binarySearchFirstOccurrence, including duplicates and partial levels.
+ */
+void testEytzingerIndex() {
+    std::cout << "\n=== Eytzinger Index ===" << std::endl;
+
+    std::vector<int> arr = {1, 3, 5, 7, 9, 11, 13, 15, 17, 19};
+    EytzingerIndex<int> index(arr);
+    std::cout << "Find 7: " << index.find(7) << ", find 6: " << index.find(6)
+              << ", lowerBound(6): " << index.lowerBound(6)
+              << ", lowerBound(20): " << index.lowerBound(20) << std::endl;
+
+    std::mt19937 rng(36);
+    bool allMatch = true;
+    for (size_t n = 0; n <= 300; n++) {
+        std::uniform_int_distribution<int> dist(0, static_cast<int>(n));
+        std::vector<int> sorted(n);
+        for (int& value : sorted) {
+            value = dist(rng);
+        }
+        std::sort(sorted.begin(), sorted.end());
+
+        EytzingerIndex<int> eytzinger(sorted);
+        for (int target = -1; target <= static_cast<int>(n) + 1; target++) {
+            size_t expected = std::lower_bound(sorted.begin(), sorted.end(), target) - sorted.begin();
+            allMatch = allMatch && eytzinger.lowerBound(target) == expected
+                       && eytzinger.find(target) == binarySearchFirstOccurrence(sorted, target);
+        }
+    }
+    std::cout << "Random arrays match std::lower_bound and binarySearchFirstOccurrence: "
+              << (allMatch ? "yes" : "no") << std::endl;
+}
+
+/**
+ * Test function for STreeIndex against std::lower_bound, on sizes that
+ * give one to three layers and partial nodes at every layer.
+ */
+void testSTreeIndex() {
+    std::cout << "\n=== S-Tree Index ===" << std::endl;
+
+    std::vector<int> arr = {1, 3, 5, 7, 9, 11, 13, 15, 17, 19};
+    STreeIndex index(arr);
+    std::cout << "Find 7: " << index.find(7) << ", find 6: " << index.find(6)
+              << ", lowerBound(20): " << index.lowerBound(20) << std::endl;
+
+    std::mt19937 rng(38);
+    bool allMatch = true;
+    for (size_t n : {0, 1, 15, 16, 17, 100, 272, 273, 289, 1000, 4624, 4625, 5000}) {
+        std::uniform_int_distribution<int> dist(-static_cast<int>(n), static_cast<int>(n));
+        std::vector<int> sorted(n);
+        for (int& value : sorted) {
+            value = dist(rng);
+        }
+        if (n > 1) {
+            sorted[0] = INT_MIN;
+            sorted[n - 1] = INT_MAX;
+        }
+        std::sort(sorted.begin(), sorted.end());
+
+        STreeIndex stree(sorted);
+        std::vector<int> targets = {INT_MIN, INT_MAX};
+        for (int target = -static_cast<int>(n) - 1; target <= static_cast<int>(n) + 1; target++) {
+            targets.push_back(target);
+        }
+        for (int target : targets) {
+            size_t expected = std::lower_bound(sorted.begin(), sorted.end(), target) - sorted.begin();
+            allMatch = allMatch && stree.lowerBound(target) == expected
+                       && stree.find(target) == binarySearch(sorted, target);
+        }
+    }
+    std::cout << "Random arrays match std::lower_bound and binarySearch: "
+              << (allMatch ? "yes" : "no") << std::endl;
+}
+
+/**
+ * Test function for binarySearchBatch against one binarySearch per target,
+ * with a batch size that leaves a partial group at the end.
+ */
+void testBinarySearchBatch() {
+    std::cout << "\n=== Batched Lookups ===" << std::endl;
+
+    std::vector<int> arr = {1, 3, 5, 7, 9, 11, 13, 15, 17, 19};
+    int targets[] = {7, 6, 1, 19, 20, 0};
+    std::ptrdiff_t results[6];
+    binarySearchBatch(arr, targets, 6, results);
+    std::cout << "Targets 7, 6, 1, 19, 20, 0 -> ";
+    printVector(std::vector<int>(results, results + 6));
+    std::cout << std::endl;
+
+    std::mt19937 rng(39);
+    bool allMatch = true;
+    for (size_t n : {0, 1, 2, 17, 1000}) {
+        std::uniform_int_distribution<int> dist(0, static_cast<int>(n));
+        std::vector<int> sorted(n);
+        for (int& value : sorted) {
+            value = dist(rng);
+        }
+        std::sort(sorted.begin(), sorted.end());
+
+        std::vector<int> queries(1000 + n);
+        for (int& query : queries) {
+            query = dist(rng) - 1;
+        }
+        std::vector<std::ptrdiff_t> batched(queries.size());
+        binarySearchBatch(sorted, queries.data(), queries.size(), batched.data());
+        for (size_t i = 0; i < queries.size(); i++) {
+            allMatch = allMatch && batched[i] == binarySearch(sorted, queries[i]);
+        }
+    }
+    std::cout << "Random batches match binarySearch: " << (allMatch ? "yes" : "no") << std::endl;
+}
+
+/**
+ * Test function for PgmIndex against std::lower_bound, with duplicate
+ * runs, gaps, extreme keys and several error bounds.
+ */
+void testPgmIndex() {
+    std::cout << "\n=== PGM Learned Index ===" << std::endl;
+
+    std::vector<int> arr = {1, 3, 5, 7, 9, 11, 13, 15, 17, 19};
+    PgmIndex<int> index(arr, 2);
+    std::cout << "Find 7: " << index.find(7) << ", find 6: " << index.find(6)
+              << ", lowerBound(20): " << index.lowerBound(20)
+              << " (" << index.stats().segments << " segment(s))" << std::endl;
+
+    std::mt19937 rng(40);
+    bool allMatch = true;
+    for (size_t epsilon : {0, 1, 4, 32}) {
+        for (size_t n : {0, 1, 2, 50, 3000}) {
+            // Mix of tight runs, duplicates and large jumps
+            std::vector<int> sorted(n);
+            int key = INT_MIN;
+            for (size_t i = 0; i < n; i++) {
+                int step = static_cast<int>(rng() % 4 == 0 ? rng() % 100000 : rng() % 3);
+                key = i == 0 ? INT_MIN + static_cast<int>(rng() % 3) : key + step;
+                sorted[i] = key;
+            }
+            if (n > 2) {
+                sorted[n - 1] = INT_MAX;
+            }
+
+            PgmIndex<int> pgm(sorted, epsilon, epsilon);
+            std::vector<int> targets = {INT_MIN, INT_MIN + 1, INT_MAX - 1, INT_MAX};
+            for (size_t i = 0; i < n; i++) {
+                targets.push_back(sorted[i]);
+                targets.push_back(sorted[i] == INT_MAX ? INT_MAX : sorted[i] + 1);
+                targets.push_back(sorted[i] == INT_MIN ? INT_MIN : sorted[i] - 1);
+            }
+            for (int target : targets) {
+                size_t expected = std::lower_bound(sorted.begin(), sorted.end(), target) - sorted.begin();
+                allMatch = allMatch && pgm.lowerBound(target) == expected
+                           && pgm.find(target) == binarySearch(sorted, target);
+            }
+        }
+    }
+    // 64-bit keys beyond 2^53, where doubles cannot hold the keys exactly
+    auto checkWide = [&rng](auto first) {
+        using Key = decltype(first);
+        std::vector<Key> sorted(100000);
+        Key key = first;
+        for (Key& value : sorted) {
+            key += static_cast<Key>(1 + rng() % 1000);
+            value = key;
+        }
+        PgmIndex<Key> pgm(sorted, 4, 4);
+        bool ok = true;
+        for (size_t i = 0; i < sorted.size() && ok; i++) {
+            for (Key target : {sorted[i] - 1, sorted[i], sorted[i] + 1}) {
+                size_t expected = std::lower_bound(sorted.begin(), sorted.end(), target) - sorted.begin();
+                ok = pgm.lowerBound(target) == expected;
+            }
+        }
+        return ok;
+    };
+    allMatch = allMatch && checkWide(static_cast<int64_t>(1) << 62) && checkWide(-(static_cast<int64_t>(1) << 62))
+               && checkWide((static_cast<uint64_t>(1) << 63) + 12345);
+
+    std::cout << "Random arrays (including 64-bit keys above 2^53) match std::lower_bound and binarySearch: "
+              << (allMatch ? "yes" : "no") << std::endl;
+}
+
+/**
+ * Test function for the interpolation modes against std::lower_bound on
+ * uniform, skewed and duplicate-heavy keys, and for the mode selector.
+ */
+void testInterpolationSearch() {
+    std::cout << "\n=== Interpolation Search ===" << std::endl;
+
+    std::vector<int> arr = {1, 3, 5, 7, 9, 11, 13, 15, 17, 19};
+    std::cout << "Find 7: " << interpolationSearch(arr, 7) << ", find 6: " << interpolationSearch(arr, 6)
+              << ", three-point find 19: " << interpolationSearch(arr, 19, InterpolationMode::ThreePoint)
+              << std::endl;
+
+    std::mt19937 rng(41);
+    std::vector<std::vector<int>> arrays;
+    for (size_t n : {0, 1, 2, 40, 5000}) {
+        std::vector<int> uniform(n);
+        std::vector<int> skewed(n);
+        std::vector<int> duplicates(n);
+        for (size_t i = 0; i < n; i++) {
+            uniform[i] = static_cast<int>(rng() % (4 * n + 1)) - static_cast<int>(2 * n);
+            skewed[i] = static_cast<int>(std::min(std::exp(i * 20.0 / (n + 1)), 2e9));
+            duplicates[i] = static_cast<int>(rng() % 4) * (rng() % 2 ? INT_MAX / 4 : -INT_MAX / 4);
+        }
+        std::sort(uniform.begin(), uniform.end());
+        std::sort(duplicates.begin(), duplicates.end());
+        arrays.push_back(uniform);
+        arrays.push_back(skewed);
+        arrays.push_back(duplicates);
+    }
+
+    const InterpolationMode modes[] = {InterpolationMode::Binary, InterpolationMode::Interpolation,
+                                       InterpolationMode::InterpolationSequential, InterpolationMode::ThreePoint};
+    bool allMatch = true;
+    for (const std::vector<int>& sorted : arrays) {
+        std::vector<int> targets = {INT_MIN, INT_MAX, 0};
+        for (int value : sorted) {
+            targets.push_back(value);
+            targets.push_back(value == INT_MAX ? value : value + 1);
+        }
+        for (InterpolationMode mode : modes) {
+            for (int target : targets) {
+                size_t expected = std::lower_bound(sorted.begin(), sorted.end(), target) - sorted.begin();
+                allMatch = allMatch && interpolationLowerBound(sorted.data(), sorted.size(), target, mode) == expected
+                           && interpolationSearch(sorted, target, mode) == binarySearch(sorted, target);
+            }
+        }
+    }
+    std::cout << "Uniform, skewed and duplicate keys match std::lower_bound in every mode: "
+              << (allMatch ? "yes" : "no") << std::endl;
+
+    InterpolationSearchIndex uniformIndex(arrays[12]);
+    InterpolationSearchIndex skewedIndex(arrays[13]);
+    std::cout << "Selected modes: uniform -> " << interpolationModeName(uniformIndex.mode())
+              << ", exponential -> " << interpolationModeName(skewedIndex.mode()) << std::endl;
+}
+
+/**
+ * Test function for gallopLowerBound from every hint, and for a
+ * SearchCursor fed ascending, descending and random targets.
+ */
+void testGallopingSearch() {
+    std::cout << "\n=== Galloping Search ===" << std::endl;
+
+    std::vector<int> arr = {1, 3, 5, 7, 9, 11, 13, 15, 17, 19};
+    SearchCursor<int> cursor(arr);
+    std::cout << "Cursor finds 3, 7, 19, 6: " << cursor.find(3) << ", " << cursor.find(7) << ", "
+              << cursor.find(19) << ", " << cursor.find(6) << " (from hint 9: "
+              << binarySearchFromHint(arr, 17, 9) << ")" << std::endl;
+
+    std::mt19937 rng(42);
+    bool allMatch = true;
+    for (size_t n : {0, 1, 2, 33, 300}) {
+        std::uniform_int_distribution<int> dist(0, static_cast<int>(n / 2));
+        std::vector<int> sorted(n);
+        for (int& value : sorted) {
+            value = dist(rng);
+        }
+        std::sort(sorted.begin(), sorted.end());
+
+        for (int target = -1; target <= static_cast<int>(n / 2) + 1; target++) {
+            size_t expected = std::lower_bound(sorted.begin(), sorted.end(), target) - sorted.begin();
+            for (size_t hint = 0; hint <= n + 1; hint++) {
+                allMatch = allMatch && gallopLowerBound(sorted.data(), n, target, hint) == expected;
+            }
+        }
+
+        SearchCursor<int> walker(sorted);
+        std::vector<int> targets;
+        for (int target = -1; target <= static_cast<int>(n / 2) + 1; target++) {
+            targets.push_back(target);
+        }
+        std::vector<int> descending(targets.rbegin(), targets.rend());
+        targets.insert(targets.end(), descending.begin(), descending.end());
+        for (size_t i = 0; i < n; i++) {
+            targets.push_back(dist(rng));
+        }
+        for (int target : targets) {
+            allMatch = allMatch && walker.find(target) == binarySearch(sorted, target);
+        }
+    }
+    std::cout << "Every hint and cursor walk matches std::lower_bound and binarySearch: "
+              << (allMatch ? "yes" : "no") << std::endl;
+}
+
+/**
+ * Test function for the set operations against the standard algorithms,
+ * for every strategy, size ratio and the count-only and k-way forms.
+ */
+void testSetOperations() {
+    std::cout << "\n=== Set Intersection and Union ===" << std::endl;
+
+    std::vector<int> evens = {0, 2, 4, 6, 8, 10, 12};
+    std::vector<int> threes = {0, 3, 6, 9, 12};
+    std::cout << "Intersection: ";
+    printVector(setIntersection(evens, threes));
+    std::cout << ", union: ";
+    printVector(setUnion(evens, threes));
+    std::cout << ", difference: ";
+    printVector(setDifference(evens, threes));
+    std::cout << std::endl;
+
+    std::mt19937 rng(43);
+    auto randomSet = [&rng](size_t size, int range) {
+        std::vector<int> values(size);
+        for (int& value : values) {
+            value = static_cast<int>(rng() % range) - range / 2;
+        }
+        std::sort(values.begin(), values.end());
+        values.erase(std::unique(values.begin(), values.end()), values.end());
+        return values;
+    };
+
+    const SetAlgorithm algorithms[] = {SetAlgorithm::Auto, SetAlgorithm::Merge,
+                                       SetAlgorithm::Gallop, SetAlgorithm::Simd};
+    bool allMatch = true;
+    for (size_t small : {0, 1, 5, 50, 1000}) {
+        for (size_t large : {0, 3, 100, 5000}) {
+            std::vector<int> a = randomSet(small, 4000);
+            std::vector<int> b = randomSet(large, 4000);
+
+            std::vector<int> expected;
+            std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected));
+            for (SetAlgorithm algorithm : algorithms) {
+                allMatch = allMatch && setIntersection(a, b, algorithm) == expected
+                           && setIntersection(b, a, algorithm) == expected
+                           && setIntersectionCount(a, b, algorithm) == expected.size();
+            }
+
+            std::vector<int> united;
+            std::set_union(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(united));
+            std::vector<int> aMinusB;
+            std::set_difference(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(aMinusB));
+            std::vector<int> bMinusA;
+            std::set_difference(b.begin(), b.end(), a.begin(), a.end(), std::back_inserter(bMinusA));
+            allMatch = allMatch && setUnion(a, b) == united && setUnion(b, a) == united
+                       && setDifference(a, b) == aMinusB && setDifference(b, a) == bMinusA;
+        }
+    }
+
+    std::vector<std::vector<int>> lists = {randomSet(3000, 6000), randomSet(200, 6000),
+                                           randomSet(5000, 6000), randomSet(2500, 6000)};
+    std::vector<int> expected = lists[0];
+    for (size_t k = 1; k < lists.size(); k++) {
+        std::vector<int> next;
+        std::set_intersection(expected.begin(), expected.end(), lists[k].begin(), lists[k].end(),
+                              std::back_inserter(next));
+        expected = next;
+    }
+    allMatch = allMatch && setIntersection(lists) == expected && setIntersectionCount(lists) == expected.size()
+               && setIntersection(std::vector<std::vector<int>>{}).empty();
+
+    std::cout << "All strategies, ratios, counts and 4-way intersection match the standard algorithms: "
+              << (allMatch ? "yes" : "no") << std::endl;
+}
+
+/**
+ * Test function for indices beyond 2^32: a sparse temporary file of
+ * 2^32 + 64 ints (zeros, stored as holes, followed by 1..64) is mapped
+ * and searched, touching only the pages the probes land on.
+ */
+void testBeyond4GElements() {
+    std::cout << "\n=== Indices Beyond 2^32 Elements ===" << std::endl;
+#ifdef BINARY_SEARCH_HAVE_LARGE_MMAP
+    const size_t zeros = size_t{1} << 32;
+    const size_t n = zeros + 64;
+    char path[] = "/tmp/binary_search_large_XXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0) {
+        std::cout << "Skipped: cannot create a temporary file" << std::endl;
+        return;
+    }
+    unlink(path);
+
+    int tail[64];
+    for (int i = 0; i < 64; i++) {
+        tail[i] = i + 1;
+    }
+    size_t bytes = n * sizeof(int);
+    bool written = ftruncate(fd, static_cast<off_t>(bytes)) == 0
+                   && pwrite(fd, tail, sizeof(tail), static_cast<off_t>(zeros * sizeof(int)))
+                          == static_cast<ssize_t>(sizeof(tail));
+    void* mapping = written ? mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        std::cout << "Skipped: cannot map a 16 GiB sparse file" << std::endl;
+        return;
+    }
+    const int* data = static_cast<const int*>(mapping);
+
+    std::ptrdiff_t index = binarySearch(data, n, 1);
+    std::cout << "Array of " << n << " ints, find 1: " << index << ", find 65: "
+              << binarySearch(data, n, 65) << std::endl;
+
+    bool allMatch = index == static_cast<std::ptrdiff_t>(zeros)
+                    && binarySearch(data, n, 64) == static_cast<std::ptrdiff_t>(n - 1)
+                    && binarySearch(data, n, 65) == notFound
+                    && upperBoundBranchless(data, n, 0) == zeros
+                    && gallopLowerBound(data, n, 10, size_t{0}) == zeros + 9
+                    && interpolationLowerBound(data, n, 40, InterpolationMode::ThreePoint) == zeros + 39;
+    std::cout << "Indices past 2^32 are exact: " << (allMatch ? "yes" : "no") << std::endl;
+
+    munmap(mapping, bytes);
+#else
+    std::cout << "Skipped: needs a 64-bit POSIX system" << std::endl;
+#endif
+}
+
+/**
+ * Test function for equalRange and countInRange against std::equal_range
+ * and a linear count, on random arrays with many duplicates.
+ */
+void testEqualRange() {
+    std::cout << "\n=== Fused Equal Range ===" << std::endl;
+
+    std::vector<int> arr = {1, 2, 2, 2, 2, 3, 4, 5};
+    std::pair<size_t, size_t> range = equalRange(arr, 2);
+    std::cout << "Range of 2: [" << range.first << ", " << range.second << "), values in [2, 4]: "
+              << countInRange(arr, 2, 4) << std::endl;
+
+    std::mt19937 rng(46);
+    bool allMatch = countInRange(arr, 3, 2) == 0 && countInRange(arr, INT_MIN, INT_MAX) == arr.size();
+    for (size_t n : {0, 1, 2, 3, 17, 100, 1000}) {
+        std::uniform_int_distribution<int> dist(0, static_cast<int>(n / 4) + 1);
+        std::vector<int> sorted(n);
+        for (int& value : sorted) {
+            value = dist(rng);
+        }
+        std::sort(sorted.begin(), sorted.end());
+
+        for (int lo = -1; lo <= static_cast<int>(n / 4) + 2; lo++) {
+            auto expected = std::equal_range(sorted.begin(), sorted.end(), lo);
+            range = equalRange(sorted, lo);
+            allMatch = allMatch && range.first == static_cast<size_t>(expected.first - sorted.begin())
+                       && range.second == static_cast<size_t>(expected.second - sorted.begin());
+            for (int hi = lo; hi <= lo + 3; hi++) {
+                size_t count = std::count_if(sorted.begin(), sorted.end(),
+                                             [lo, hi](int value) { return lo <= value && value <= hi; });
+                allMatch = allMatch && countInRange(sorted, lo, hi) == count;
+            }
+        }
+    }
+    std::cout << "Random ranges and counts match std::equal_range: " << (allMatch ? "yes" : "no") << std::endl;
+}
+
+/**
+ * Test function for FractionalCascading against std::lower_bound on
+ * every array, including empty arrays, duplicates and partial rebuilds.
+ */
+void testFractionalCascading() {
+    std::cout << "\n=== Fractional Cascading ===" << std::endl;
+
+    std::vector<std::vector<int>> arrays = {{1, 5, 9, 13}, {2, 4, 6, 8, 10}, {}, {3, 5, 5, 7}};
+    FractionalCascading cascade(arrays);
+    std::cout << "Lower bounds of 5 in " << arrays.size() << " arrays: [";
+    std::vector<size_t> positions = cascade.lowerBounds(5);
+    for (size_t i = 0; i < positions.size(); i++) {
+        std::cout << positions[i] << (i + 1 < positions.size() ? ", " : "]");
+    }
+    std::cout << std::endl;
+
+    std::mt19937 rng(47);
+    auto randomArrays = [&rng](size_t k, int range) {
+        std::vector<std::vector<int>> result(k);
+        for (std::vector<int>& array : result) {
+            array.resize(rng() % 200);
+            for (int& value : array) {
+                value = static_cast<int>(rng() % range) - range / 2;
+            }
+            std::sort(array.begin(), array.end());
+        }
+        return result;
+    };
+    auto matches = [](const FractionalCascading& index, const std::vector<std::vector<int>>& data, int range) {
+        bool ok = index.arrayCount() == data.size();
+        for (int target = -range / 2 - 2; target <= range / 2 + 2 && ok; target++) {
+            std::vector<size_t> found = index.lowerBounds(target);
+            for (size_t i = 0; i < data.size(); i++) {
+                ok = ok && found[i] == static_cast<size_t>(
+                    std::lower_bound(data[i].begin(), data[i].end(), target) - data[i].begin());
+            }
+        }
+        return ok;
+    };
+
+    bool allMatch = matches(cascade, arrays, 30) && FractionalCascading().arrayCount() == 0;
+    for (size_t k : {1, 2, 7, 20}) {
+        for (int range : {10, 1000}) {
+            std::vector<std::vector<int>> data = randomArrays(k, range);
+            FractionalCascading index(data);
+            allMatch = allMatch && matches(index, data, range);
+
+            // Change one array, then rebuild only the levels that depend on it
+            size_t changed = rng() % k;
+            data[changed] = randomArrays(1, range)[0];
+            index.rebuild(data, changed);
+            allMatch = allMatch && matches(index, data, range);
+        }
+    }
+    std::cout << "All arrays, targets and partial rebuilds match std::lower_bound: "
+              << (allMatch ? "yes" : "no") << std::endl;
+}
 
 /**
- * Performs binary search on a sorted vector using iterative approach.
- *
- * @param arr Sorted vector of comparable elements
- * @param target Element to search for
- * @return Index of target if found, -1 otherwise
+ * Test function for BPlusTree against std::multiset under random
+ * inserts and erases with many duplicates, bulk loads and bulk merges.
  */
-int binarySearch(const std::vector<int>& arr, int target) {
-    if (arr.empty()) {
-        return -1;
+void testBPlusTree() {
+    std::cout << "\n=== B+-Tree ===" << std::endl;
+
+    BPlusTree<int> tree(std::vector<int>{1, 3, 5, 7, 9});
+    tree.insert(4);
+    tree.erase(7);
+    std::cout << "Bulk-loaded [1, 3, 5, 7, 9], inserted 4, erased 7: [";
+    for (auto it = tree.begin(); it != tree.end(); ++it) {
+        std::cout << *it << (std::next(it) != tree.end() ? ", " : "");
     }
+    std::cout << "], lower bound of 6: " << *tree.lowerBound(6) << std::endl;
 
-    int left = 0;
-    int right = arr.size() - 1;
+    std::mt19937 rng(48);
+    auto matches = [](const BPlusTree<int>& index, const std::multiset<int>& expected, int range) {
+        bool ok = index.size() == expected.size() && std::equal(index.begin(), index.end(), expected.begin())
+                  && static_cast<size_t>(std::distance(index.begin(), index.end())) == expected.size();
+        for (int key = -1; key <= range + 1 && ok; key += 1 + range / 500) {
+            auto it = expected.lower_bound(key);
+            auto found = index.lowerBound(key);
+            ok = (it == expected.end()) ? found == index.end() : found != index.end() && *found == *it;
+            ok = ok && index.contains(key) == (expected.count(key) > 0);
+        }
+        return ok;
+    };
 
-    while (left <= right) {
-        // Avoid potential overflow
-        int mid = left + (right - left) / 2;
+    bool allMatch = true;
+    for (int range : {50, 1000000}) {
+        BPlusTree<int> dynamic;
+        std::multiset<int> expected;
+        for (int round = 0; round < 4; round++) {
+            // Grow well past a few levels, then shrink most of the way back
+            for (int i = 0; i < 60000; i++) {
+                int key = static_cast<int>(rng() % range);
+                dynamic.insert(key);
+                expected.insert(key);
+            }
+            allMatch = allMatch && matches(dynamic, expected, range);
+            for (int i = 0; i < 50000; i++) {
+                int key = static_cast<int>(rng() % range);
+                auto it = expected.find(key);
+                bool present = it != expected.end();
+                if (present) {
+                    expected.erase(it);
+                }
+                allMatch = allMatch && dynamic.erase(key) == present;
+            }
+            allMatch = allMatch && matches(dynamic, expected, range);
+        }
 
-        if (arr[mid] == target) {
-            return mid;
-        } else if (arr[mid] < target) {
-            left = mid + 1;
-        } else {
-            right = mid - 1;
+        // Small batches are inserted; large ones rebuild the tree
+        for (size_t batchSize : {10, 200000}) {
+            std::vector<int> batch(batchSize);
+            for (int& key : batch) {
+                key = static_cast<int>(rng() % range);
+            }
+            std::sort(batch.begin(), batch.end());
+            dynamic.merge(batch);
+            expected.insert(batch.begin(), batch.end());
+            allMatch = allMatch && matches(dynamic, expected, range);
+        }
+
+        // Erase everything, down to an empty root
+        std::vector<int> keys(expected.begin(), expected.end());
+        std::shuffle(keys.begin(), keys.end(), rng);
+        for (int key : keys) {
+            allMatch = allMatch && dynamic.erase(key);
+        }
+        allMatch = allMatch && dynamic.size() == 0 && dynamic.begin() == dynamic.end() && dynamic.height() == 1
+                   && !dynamic.erase(0);
+    }
+    std::cout << "Random inserts, erases, bulk loads and merges match std::multiset: "
+              << (allMatch ? "yes" : "no") << std::endl;
+}
+
+/**
+ * Test function for FrontCodedDictionary against a sorted vector of
+ * URL-like strings: lookups, misses, rank, select and prefix ranges.
+ */
+void testFrontCodedDictionary() {
+    std::cout << "\n=== Front-Coded String Dictionary ===" << std::endl;
+
+    std::vector<std::string> words = {"apple", "applesauce", "apply", "banana", "band", "bandana", "can"};
+    FrontCodedDictionary small(words);
+    std::pair<size_t, size_t> range = small.prefixRange("band");
+    std::cout << "find(\"apply\"): " << small.find("apply") << ", find(\"app\"): " << small.find("app")
+              << ", select(4): " << small.select(4) << ", prefix \"band\": [" << range.first << ", "
+              << range.second << ")" << std::endl;
+
+    std::mt19937 rng(49);
+    const char* hosts[] = {"https://example.com/", "https://example.org/docs/", "http://a.io/"};
+    std::vector<std::string> urls;
+    for (int i = 0; i < 5000; i++) {
+        std::string url = hosts[rng() % 3];
+        for (int depth = rng() % 4; depth >= 0; depth--) {
+            url += std::to_string(rng() % 50) + (depth > 0 ? "/" : "");
+        }
+        urls.push_back(url);
+    }
+    urls.push_back("");
+    std::sort(urls.begin(), urls.end());
+    urls.erase(std::unique(urls.begin(), urls.end()), urls.end());
+
+    std::vector<std::string> duplicated = urls;
+    duplicated.insert(duplicated.begin() + duplicated.size() / 2, urls[urls.size() / 2]);
+    FrontCodedDictionary dictionary(duplicated);
+
+    bool allMatch = dictionary.size() == urls.size() && FrontCodedDictionary().find("x") == notFound
+                    && FrontCodedDictionary().prefixRange("").second == 0 && dictionary.find("") == 0
+                    && dictionary.find("a") == notFound && dictionary.find(urls.back() + "~") == notFound;
+    for (size_t i = 0; i < urls.size(); i++) {
+        allMatch = allMatch && dictionary.find(urls[i]) == static_cast<std::ptrdiff_t>(i)
+                   && dictionary.select(i) == urls[i];
+        std::string miss = urls[i] + "~";
+        allMatch = allMatch && (dictionary.find(miss) == notFound)
+                   && dictionary.rank(miss) == static_cast<size_t>(
+                       std::lower_bound(urls.begin(), urls.end(), miss) - urls.begin());
+    }
+    for (std::string prefix : {"", "h", "http://", "https://example.com/1", "https://example.org/docs/49/",
+                               "https://example.com/zzz", "~"}) {
+        size_t first = urls.size();
+        size_t end = 0;
+        for (size_t i = 0; i < urls.size(); i++) {
+            if (urls[i].compare(0, prefix.size(), prefix) == 0) {
+                first = std::min(first, i);
+                end = i + 1;
+            }
         }
+        range = dictionary.prefixRange(prefix);
+        allMatch = allMatch && (first < end ? range.first == first && range.second == end
+                                            : range.first == range.second);
     }
 
-    return -1;
+    size_t vectorBytes = urls.size() * sizeof(std::string);
+    for (const std::string& url : urls) {
+        vectorBytes += url.capacity() >= sizeof(std::string) ? url.capacity() + 1 : 0;
+    }
+    std::cout << urls.size() << " URLs: " << dictionary.bytes() << " bytes front-coded vs about " << vectorBytes
+              << " in a std::vector<std::string>" << std::endl;
+    std::cout << "Lookups, misses, rank, select and prefix ranges match the sorted vector: "
+              << (allMatch ? "yes" : "no") << std::endl;
 }
 
 /**
- * Performs binary search on a sorted vector using recursive approach.
- *
- * @param arr Sorted vector of comparable elements
- * @param target Element to search for
- * @param left Left boundary
- * @param right Right boundary
- * @return Index of target if found, -1 otherwise
+ * Test function for FilteredSearchIndex: no false negatives, a measured
+ * false-positive rate near the target, and consistent counters.
  */
-int binarySearchRecursive(const std::vector<int>& arr, int target, int left, int right) {
-    if (left > right) {
-        return -1;
+void testFilteredSearch() {
+    std::cout << "\n=== Filtered Search ===" << std::endl;
+
+    std::vector<int> arr = {1, 3, 5, 7, 9, 11, 13, 15, 17, 19};
+    FilteredSearchIndex small(arr);
+    std::cout << "find 7: " << small.find(7) << ", find 8: " << small.find(8) << std::endl;
+
+    std::mt19937 rng(50);
+    bool allMatch = FilteredSearchIndex(std::vector<int>{}).find(0) == notFound;
+    for (double rate : {0.1, 0.01, 0.001}) {
+        std::vector<int> sorted(20000);
+        for (int& value : sorted) {
+            value = static_cast<int>(rng() % 1000000) * 2;  // Even keys only
+        }
+        std::sort(sorted.begin(), sorted.end());
+        FilteredSearchIndex index(sorted, rate);
+
+        for (size_t i = 0; i < sorted.size(); i++) {
+            allMatch = allMatch && index.find(sorted[i]) == binarySearch(sorted, sorted[i]);
+        }
+        const size_t misses = 200000;
+        for (size_t i = 0; i < misses; i++) {
+            allMatch = allMatch && index.find(static_cast<int>(rng() % 1000000) * 2 + 1) == notFound;
+        }
+
+        const FilterCounters& counters = index.counters();
+        double measured = static_cast<double>(counters.falsePositives) / misses;
+        allMatch = allMatch && counters.hits == sorted.size()
+                   && counters.definiteMisses + counters.falsePositives == misses && measured <= 2 * rate;
+        std::cout << "  target rate " << rate << ": measured " << measured << " with "
+                  << index.filterBytes() * 8.0 / sorted.size() << " bits per key" << std::endl;
     }
+    std::cout << "No false negatives, rates within 2x of target, counters consistent: "
+              << (allMatch ? "yes" : "no") << std::endl;
+}
 
-    int mid = left + (right - left) / 2;
+/**
+ * Benchmark: binarySearch against EytzingerIndex::find on random queries,
+ * half of them hits, for arrays from cache-resident up to 10^8 keys.
+ */
+void benchmarkEytzingerIndex() {
+    std::cout << "\n=== Benchmark: binarySearch vs EytzingerIndex ===" << std::endl;
 
-    if (arr[mid] == target) {
-        return mid;
-    } else if (arr[mid] < target) {
-        return binarySearchRecursive(arr, target, mid + 1, right);
-    } else {
-        return binarySearchRecursive(arr, target, left, mid - 1);
+    const size_t queryCount = 1000000;
+    std::mt19937 rng(42);
+
+    for (size_t n : {10000, 1000000, 100000000}) {
+        // Distinct even keys, so both searches agree on the index of a hit
+        std::vector<int> sorted(n);
+        for (size_t i = 0; i < n; i++) {
+            sorted[i] = static_cast<int>(2 * i);
+        }
+        std::uniform_int_distribution<int> dist(0, static_cast<int>(2 * n - 1));
+        std::vector<int> queries(queryCount);
+        for (int& query : queries) {
+            query = dist(rng);
+        }
+
+        auto start = std::chrono::high_resolution_clock::now();
+        EytzingerIndex<int> index(sorted);
+        auto end = std::chrono::high_resolution_clock::now();
+        double buildMs = std::chrono::duration<double, std::milli>(end - start).count();
+
+        long long binaryChecksum = 0;
+        start = std::chrono::high_resolution_clock::now();
+        for (int query : queries) {
+            binaryChecksum += binarySearch(sorted, query);
+        }
+        end = std::chrono::high_resolution_clock::now();
+        double binaryNs = std::chrono::duration<double, std::nano>(end - start).count() / queryCount;
+
+        long long eytzingerChecksum = 0;
+        start = std::chrono::high_resolution_clock::now();
+        for (int query : queries) {
+            eytzingerChecksum += index.find(query);
+        }
+        end = std::chrono::high_resolution_clock::now();
+        double eytzingerNs = std::chrono::duration<double, std::nano>(end - start).count() / queryCount;
+
+        std::cout << "  n=" << n << ": binarySearch " << binaryNs << " ns/lookup, Eytzinger "
+                  << eytzingerNs << " ns/lookup, speedup " << binaryNs / eytzingerNs << "x (build "
+                  << buildMs << " ms)" << (binaryChecksum == eytzingerChecksum ? "" : "  MISMATCH")
+                  << std::endl;
     }
 }
 
 /**
- * Wrapper function for recursive binary search.
+ * Benchmark: the branchy std::lower_bound against the branchless kernel
+ * on random queries, where the branchy loop mispredicts about half of
+ * its comparisons.
  */
-int binarySearchRecursive(const std::vector<int>& arr, int target) {
-    if (arr.empty()) {
-        return -1;
+void benchmarkBranchlessBounds() {
+    std::cout << "\n=== Benchmark: branchy vs branchless lower bound ===" << std::endl;
+
+    const size_t queryCount = 1000000;
+    std::mt19937 rng(42);
+
+    for (size_t n : {1000, 100000, 10000000}) {
+        std::vector<int> sorted(n);
+        for (size_t i = 0; i < n; i++) {
+            sorted[i] = static_cast<int>(2 * i);
+        }
+        std::uniform_int_distribution<int> dist(0, static_cast<int>(2 * n - 1));
+        std::vector<int> queries(queryCount);
+        for (int& query : queries) {
+            query = dist(rng);
+        }
+
+        size_t branchyChecksum = 0;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int query : queries) {
+            branchyChecksum += std::lower_bound(sorted.begin(), sorted.end(), query) - sorted.begin();
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        double branchyNs = std::chrono::duration<double, std::nano>(end - start).count() / queryCount;
+
+        size_t branchlessChecksum = 0;
+        start = std::chrono::high_resolution_clock::now();
+        for (int query : queries) {
+            branchlessChecksum += lowerBoundBranchless(sorted.data(), n, query);
+        }
+        end = std::chrono::high_resolution_clock::now();
+        double branchlessNs = std::chrono::duration<double, std::nano>(end - start).count() / queryCount;
+
+        std::cout << "  n=" << n << ": branchy " << branchyNs << " ns/lookup, branchless "
+                  << branchlessNs << " ns/lookup, speedup " << branchyNs / branchlessNs << "x"
+                  << (branchyChecksum == branchlessChecksum ? "" : "  MISMATCH") << std::endl;
     }
-    return binarySearchRecursive(arr, target, 0, arr.size() - 1);
 }
 
 /**
- * Binary search with step-by-step visualization.
- *
- * @param arr Sorted vector to search in
- * @param target Element to search for
- * @return Index of target if found, -1 otherwise
+ * Benchmark: binarySearch, EytzingerIndex and STreeIndex on random
+ * queries for arrays sized to sit in L1, L2, L3 and DRAM.
  */
-int binarySearchVerbose(const std::vector<int>& arr, int target) {
-    if (arr.empty()) {
-        std::cout << "Empty array provided" << std::endl;
-        return -1;
+void benchmarkSTreeIndex() {
+    std::cout << "\n=== Benchmark: binarySearch vs EytzingerIndex vs STreeIndex ===" << std::endl;
+
+    const size_t queryCount = 1000000;
+    std::mt19937 rng(42);
+
+    const std::pair<const char*, size_t> sizes[] = {
+        {"L1", 4000}, {"L2", 200000}, {"L3", 8000000}, {"DRAM", 100000000}
+    };
+    for (const auto& size : sizes) {
+        size_t n = size.second;
+        std::vector<int> sorted(n);
+        for (size_t i = 0; i < n; i++) {
+            sorted[i] = static_cast<int>(2 * i);
+        }
+        std::uniform_int_distribution<int> dist(0, static_cast<int>(2 * n - 1));
+        std::vector<int> queries(queryCount);
+        for (int& query : queries) {
+            query = dist(rng);
+        }
+
+        double nsPerLookup[3];
+        long long checksums[3] = {0, 0, 0};
+        auto time = [&](int slot, auto&& lookup) {
+            auto start = std::chrono::high_resolution_clock::now();
+            for (int query : queries) {
+                checksums[slot] += lookup(query);
+            }
+            auto end = std::chrono::high_resolution_clock::now();
+            nsPerLookup[slot] = std::chrono::duration<double, std::nano>(end - start).count() / queryCount;
+        };
+
+        time(0, [&sorted](int query) { return binarySearch(sorted, query); });
+        {
+            EytzingerIndex<int> eytzinger(sorted);
+            time(1, [&eytzinger](int query) { return eytzinger.find(query); });
+        }
+        STreeIndex stree(sorted);
+        time(2, [&stree](int query) { return stree.find(query); });
+
+        bool same = checksums[0] == checksums[1] && checksums[0] == checksums[2];
+        std::cout << "  " << size.first << " (n=" << n << ", " << stree.height() << " layers): binarySearch "
+                  << nsPerLookup[0] << " ns, Eytzinger " << nsPerLookup[1] << " ns, S-tree "
+                  << nsPerLookup[2] << " ns" << (same ? "" : "  MISMATCH") << std::endl;
     }
+}
 
-    int left = 0;
-    int right = arr.size() - 1;
-    int steps = 0;
+/**
+ * Benchmark: throughput of a loop of binarySearch calls against
+ * binarySearchBatch on the same million random targets.
+ */
+void benchmarkBinarySearchBatch() {
+    std::cout << "\n=== Benchmark: one-at-a-time vs batched lookups ===" << std::endl;
 
-    std::cout << "Searching for " << target << " in array: [";
-    for (size_t i = 0; i < arr.size(); ++i) {
-        std::cout << arr[i];
-        if (i < arr.size() - 1) std::cout << ", ";
+    const size_t queryCount = 1000000;
+    std::mt19937 rng(42);
+
+    for (size_t n : {200000, 8000000, 100000000}) {
+        std::vector<int> sorted(n);
+        for (size_t i = 0; i < n; i++) {
+            sorted[i] = static_cast<int>(2 * i);
+        }
+        std::uniform_int_distribution<int> dist(0, static_cast<int>(2 * n - 1));
+        std::vector<int> queries(queryCount);
+        for (int& query : queries) {
+            query = dist(rng);
+        }
+
+        std::vector<std::ptrdiff_t> single(queryCount);
+        auto start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < queryCount; i++) {
+            single[i] = binarySearch(sorted, queries[i]);
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        double singleMs = std::chrono::duration<double, std::milli>(end - start).count();
+
+        std::vector<std::ptrdiff_t> batched(queryCount);
+        start = std::chrono::high_resolution_clock::now();
+        binarySearchBatch(sorted, queries.data(), queryCount, batched.data());
+        end = std::chrono::high_resolution_clock::now();
+        double batchedMs = std::chrono::duration<double, std::milli>(end - start).count();
+
+        std::cout << "  n=" << n << ": one-at-a-time " << queryCount / singleMs / 1000
+                  << " M lookups/s, batched " << queryCount / batchedMs / 1000 << " M lookups/s, speedup "
+                  << singleMs / batchedMs << "x" << (single == batched ? "" : "  MISMATCH") << std::endl;
     }
-    std::cout << "]" << std::endl;
-    std::cout << "Array length: " << arr.size() << std::endl;
+}
 
-    while (left <= right) {
-        steps++;
-        int mid = left + (right - left) / 2;
+/**
+ * Benchmark: binarySearch against PgmIndex at several error bounds on
+ * near-uniform keys, with each index's build report.
+ */
+void benchmarkPgmIndex() {
+    std::cout << "\n=== Benchmark: binarySearch vs PgmIndex ===" << std::endl;
 
-        std::cout << "\nStep " << steps << ":" << std::endl;
-        std::cout << "  left=" << left << ", right=" << right << ", mid=" << mid << std::endl;
-        std::cout << "  arr[" << mid << "] = " << arr[mid] << std::endl;
+    const size_t queryCount = 1000000;
+    std::mt19937 rng(42);
 
-        if (arr[mid] == target) {
-            std::cout << "  Target found at index " << mid << "!" << std::endl;
-            return mid;
-        } else if (arr[mid] < target) {
-            std::cout << "  " << arr[mid] << " < " << target << ", search right half" << std::endl;
-            left = mid + 1;
-        } else {
-            std::cout << "  " << arr[mid] << " > " << target << ", search left half" << std::endl;
-            right = mid - 1;
+    for (size_t n : {1000000, 100000000}) {
+        // Random gaps of 1 to 20 keep the keys near-uniform
+        std::vector<int> sorted(n);
+        int key = 0;
+        for (int& value : sorted) {
+            key += 1 + static_cast<int>(rng() % 20);
+            value = key;
+        }
+        std::uniform_int_distribution<int> dist(0, key);
+        std::vector<int> queries(queryCount);
+        for (int& query : queries) {
+            query = dist(rng);
+        }
+
+        long long expected = 0;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int query : queries) {
+            expected += binarySearch(sorted, query);
         }
+        auto end = std::chrono::high_resolution_clock::now();
+        double binaryNs = std::chrono::duration<double, std::nano>(end - start).count() / queryCount;
+        std::cout << "  n=" << n << " (" << n * sizeof(int) / (1024 * 1024) << " MiB of keys): binarySearch "
+                  << binaryNs << " ns/lookup" << std::endl;
+
+        for (size_t epsilon : {16, 64, 256}) {
+            PgmIndex<int> pgm(sorted, epsilon);
+            long long checksum = 0;
+            start = std::chrono::high_resolution_clock::now();
+            for (int query : queries) {
+                checksum += pgm.find(query);
+            }
+            end = std::chrono::high_resolution_clock::now();
+            double pgmNs = std::chrono::duration<double, std::nano>(end - start).count() / queryCount;
+
+            const PgmIndexStats& stats = pgm.stats();
+            std::cout << "    epsilon=" << stats.epsilon << ": " << pgmNs << " ns/lookup, "
+                      << stats.levels << " levels, " << stats.segments << " segments, "
+                      << stats.bytes << " bytes, built in " << stats.buildMs << " ms"
+                      << (checksum == expected ? "" : "  MISMATCH") << std::endl;
+        }
+    }
+}
+
+/**
+ * Benchmark: binarySearch against every interpolation mode, and the mode
+ * InterpolationSearchIndex selects, on uniform and exponential keys.
+ */
+void benchmarkInterpolationSearch() {
+    std::cout << "\n=== Benchmark: binarySearch vs interpolation modes ===" << std::endl;
+
+    const size_t n = 10000000;
+    const size_t queryCount = 1000000;
+    std::mt19937 rng(42);
+
+    std::vector<int> uniform(n);
+    std::vector<int> exponential(n);
+    for (size_t i = 0; i < n; i++) {
+        uniform[i] = static_cast<int>(rng() % INT_MAX);
+        exponential[i] = static_cast<int>(std::exp(i * 21.0 / n));
     }
+    std::sort(uniform.begin(), uniform.end());
 
-    std::cout << "\nTarget " << target << " not found in array after " << steps << " steps" << std::endl;
-    return -1;
+    const std::pair<const char*, const std::vector<int>*> datasets[] = {
+        {"uniform", &uniform}, {"exponential", &exponential}
+    };
+    const InterpolationMode modes[] = {InterpolationMode::Interpolation,
+                                       InterpolationMode::InterpolationSequential, InterpolationMode::ThreePoint};
+    for (const auto& dataset : datasets) {
+        const std::vector<int>& sorted = *dataset.second;
+        std::vector<int> queries(queryCount);
+        for (int& query : queries) {
+            query = sorted[rng() % n];
+        }
+
+        auto time = [&queries](auto&& lookup, long long& checksum) {
+            auto start = std::chrono::high_resolution_clock::now();
+            for (int query : queries) {
+                checksum += lookup(query);
+            }
+            auto end = std::chrono::high_resolution_clock::now();
+            return std::chrono::duration<double, std::nano>(end - start).count() / queries.size();
+        };
+
+        long long expected = 0;
+        double binaryNs = time([&sorted](int query) { return binarySearch(sorted, query); }, expected);
+        InterpolationSearchIndex index(sorted);
+        std::cout << "  " << dataset.first << " (n=" << n << ", selected "
+                  << interpolationModeName(index.mode()) << "): binarySearch " << binaryNs << " ns" << std::endl;
+
+        for (InterpolationMode mode : modes) {
+            long long checksum = 0;
+            double ns = time([&sorted, mode](int query) { return interpolationSearch(sorted, query, mode); },
+                             checksum);
+            std::cout << "    " << interpolationModeName(mode) << ": " << ns << " ns"
+                      << (checksum == expected ? "" : "  MISMATCH") << std::endl;
+        }
+    }
 }
 
 /**
- * Find the first occurrence of target in a sorted vector with duplicates.
- *
- * @param arr Sorted vector that may contain duplicates
- * @param target Element to search for
- * @return Index of first occurrence, -1 if not found
+ * Benchmark: binarySearch against a SearchCursor on a roughly ascending
+ * stream of targets, each a short random distance past the previous one.
  */
-int binarySearchFirstOccurrence(const std::vector<int>& arr, int target) {
-    if (arr.empty()) {
-        return -1;
+void benchmarkGallopingSearch() {
+    std::cout << "\n=== Benchmark: binarySearch vs SearchCursor on ascending queries ===" << std::endl;
+
+    const size_t n = 10000000;
+    std::mt19937 rng(42);
+
+    std::vector<int> sorted(n);
+    for (size_t i = 0; i < n; i++) {
+        sorted[i] = static_cast<int>(2 * i);
     }
 
-    int left = 0;
-    int right = arr.size() - 1;
-    int result = -1;
+    for (int maxStep : {8, 512, 32768}) {
+        std::vector<int> queries;
+        for (int query = 0; query < static_cast<int>(2 * n); query += 1 + static_cast<int>(rng() % maxStep)) {
+            queries.push_back(query);
+        }
 
-    while (left <= right) {
-        int mid = left + (right - left) / 2;
+        long long binaryChecksum = 0;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int query : queries) {
+            binaryChecksum += binarySearch(sorted, query);
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        double binaryNs = std::chrono::duration<double, std::nano>(end - start).count() / queries.size();
 
-        if (arr[mid] == target) {
-            result = mid;
-            right = mid - 1; // Continue searching in left half
-        } else if (arr[mid] < target) {
-            left = mid + 1;
-        } else {
-            right = mid - 1;
+        long long cursorChecksum = 0;
+        SearchCursor<int> cursor(sorted);
+        start = std::chrono::high_resolution_clock::now();
+        for (int query : queries) {
+            cursorChecksum += cursor.find(query);
         }
+        end = std::chrono::high_resolution_clock::now();
+        double cursorNs = std::chrono::duration<double, std::nano>(end - start).count() / queries.size();
+
+        std::cout << "  average distance " << (maxStep + 1) / 4 << " keys: binarySearch " << binaryNs
+                  << " ns/lookup, cursor " << cursorNs << " ns/lookup, speedup " << binaryNs / cursorNs << "x"
+                  << (binaryChecksum == cursorChecksum ? "" : "  MISMATCH") << std::endl;
     }
+}
 
-    return result;
+/**
+ * Benchmark: each intersection strategy, and the automatic choice, at
+ * several size ratios between the two sets.
+ */
+void benchmarkSetIntersection() {
+    std::cout << "\n=== Benchmark: set intersection strategies by size ratio ===" << std::endl;
+
+    const size_t large = 4000000;
+    std::mt19937 rng(42);
+    auto randomSet = [&rng](size_t size) {
+        std::vector<int> values(size);
+        for (int& value : values) {
+            value = static_cast<int>(rng() % (4 * large));
+        }
+        std::sort(values.begin(), values.end());
+        values.erase(std::unique(values.begin(), values.end()), values.end());
+        return values;
+    };
+    std::vector<int> big = randomSet(large);
+
+    const std::pair<const char*, SetAlgorithm> algorithms[] = {
+        {"merge", SetAlgorithm::Merge}, {"gallop", SetAlgorithm::Gallop},
+        {"simd", SetAlgorithm::Simd}, {"auto", SetAlgorithm::Auto}
+    };
+    for (size_t ratio : {1, 8, 64, 1024}) {
+        std::vector<int> small = randomSet(large / ratio);
+        std::cout << "  1:" << ratio << " (" << small.size() << " vs " << big.size() << "):";
+        for (const auto& algorithm : algorithms) {
+            const int repeats = 5;
+            size_t count = 0;
+            auto start = std::chrono::high_resolution_clock::now();
+            for (int r = 0; r < repeats; r++) {
+                count += setIntersectionCount(small, big, algorithm.second);
+            }
+            auto end = std::chrono::high_resolution_clock::now();
+            double ms = std::chrono::duration<double, std::milli>(end - start).count() / repeats;
+            std::cout << " " << algorithm.first << " " << ms << " ms";
+            if (algorithm.second == SetAlgorithm::Auto) {
+                std::cout << " (" << count / repeats << " common)";
+            }
+        }
+        std::cout << std::endl;
+    }
 }
 
 /**
- * Find the last occurrence of target in a sorted vector with duplicates.
- *
- * @param arr Sorted vector that may contain duplicates
- * @param target Element to search for
- * @return Index of last occurrence, -1 if not found
+ * Benchmark: the fused equalRange against a first-occurrence search
+ * followed by a last-occurrence search, on random targets.
  */
-int binarySearchLastOccurrence(const std::vector<int>& arr, int target) {
-    if (arr.empty()) {
-        return -1;
+void benchmarkEqualRange() {
+    std::cout << "\n=== Benchmark: fused equal range vs two searches ===" << std::endl;
+
+    const size_t queryCount = 1000000;
+    std::mt19937 rng(42);
+    for (size_t n : {size_t{1} << 12, size_t{1} << 20, size_t{1} << 26}) {
+        std::vector<int> sorted(n);
+        for (size_t i = 0; i < n; i++) {
+            sorted[i] = static_cast<int>(i / 4);  // Runs of four duplicates
+        }
+        std::uniform_int_distribution<int> dist(0, static_cast<int>(n / 4));
+        std::vector<int> queries(queryCount);
+        for (int& query : queries) {
+            query = dist(rng);
+        }
+
+        size_t twoChecksum = 0;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int query : queries) {
+            twoChecksum += binarySearchFirstOccurrence(sorted, query) + binarySearchLastOccurrence(sorted, query);
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        double twoMs = std::chrono::duration<double, std::milli>(end - start).count();
+
+        size_t fusedChecksum = 0;
+        start = std::chrono::high_resolution_clock::now();
+        for (int query : queries) {
+            std::pair<size_t, size_t> range = equalRange(sorted, query);
+            fusedChecksum += range.first < range.second ? range.first + range.second - 1 : size_t(-2);
+        }
+        end = std::chrono::high_resolution_clock::now();
+        double fusedMs = std::chrono::duration<double, std::milli>(end - start).count();
+
+        std::cout << "  n=" << n << ": two searches " << twoMs << " ms, fused " << fusedMs << " ms, speedup "
+                  << twoMs / fusedMs << "x" << (twoChecksum == fusedChecksum ? "" : "  MISMATCH") << std::endl;
     }
+}
+
+/**
+ * Benchmark: one lower bound per array with the branchless kernel,
+ * against one FractionalCascading lookup over all arrays.
+ */
+void benchmarkFractionalCascading() {
+    std::cout << "\n=== Benchmark: independent searches vs fractional cascading ===" << std::endl;
 
-    int left = 0;
-    int right = arr.size() - 1;
-    int result = -1;
+    const size_t queryCount = 200000;
+    std::mt19937 rng(42);
+    for (size_t k : {8, 32}) {
+        for (size_t n : {size_t{1} << 10, size_t{1} << 17}) {
+            std::vector<std::vector<int>> arrays(k, std::vector<int>(n));
+            for (std::vector<int>& array : arrays) {
+                for (int& value : array) {
+                    value = static_cast<int>(rng() % (1u << 30));
+                }
+                std::sort(array.begin(), array.end());
+            }
+            std::vector<int> queries(queryCount);
+            for (int& query : queries) {
+                query = static_cast<int>(rng() % (1u << 30));
+            }
 
-    while (left <= right) {
-        int mid = left + (right - left) / 2;
+            std::vector<size_t> positions(k);
+            size_t independentChecksum = 0;
+            auto start = std::chrono::high_resolution_clock::now();
+            for (int query : queries) {
+                for (size_t i = 0; i < k; i++) {
+                    independentChecksum += lowerBoundBranchless(arrays[i].data(), n, query);
+                }
+            }
+            auto end = std::chrono::high_resolution_clock::now();
+            double independentMs = std::chrono::duration<double, std::milli>(end - start).count();
 
-        if (arr[mid] == target) {
-            result = mid;
-            left = mid + 1; // Continue searching in right half
-        } else if (arr[mid] < target) {
-            left = mid + 1;
-        } else {
-            right = mid - 1;
+            FractionalCascading cascade(arrays);
+            size_t cascadeChecksum = 0;
+            start = std::chrono::high_resolution_clock::now();
+            for (int query : queries) {
+                cascade.lowerBounds(query, positions.data());
+                for (size_t i = 0; i < k; i++) {
+                    cascadeChecksum += positions[i];
+                }
+            }
+            end = std::chrono::high_resolution_clock::now();
+            double cascadeMs = std::chrono::duration<double, std::milli>(end - start).count();
+
+            std::cout << "  k=" << k << ", n=" << n << " per array: independent " << independentMs
+                      << " ms, cascading " << cascadeMs << " ms, speedup " << independentMs / cascadeMs << "x"
+                      << (independentChecksum == cascadeChecksum ? "" : "  MISMATCH") << std::endl;
         }
     }
+}
 
-    return result;
+/**
+ * Benchmark: BPlusTree against std::multiset for random inserts and
+ * lookups, and against inserting into a sorted std::vector.
+ */
+void benchmarkBPlusTree() {
+    std::cout << "\n=== Benchmark: B+-tree vs std::multiset vs sorted vector ===" << std::endl;
+
+    std::mt19937 rng(42);
+    for (size_t n : {size_t{100000}, size_t{4000000}}) {
+        std::vector<int> keys(n);
+        for (int& key : keys) {
+            key = static_cast<int>(rng() % INT_MAX);
+        }
+
+        auto start = std::chrono::high_resolution_clock::now();
+        BPlusTree<int> tree;
+        for (int key : keys) {
+            tree.insert(key);
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        double treeInsertMs = std::chrono::duration<double, std::milli>(end - start).count();
+
+        start = std::chrono::high_resolution_clock::now();
+        std::multiset<int> set;
+        for (int key : keys) {
+            set.insert(key);
+        }
+        end = std::chrono::high_resolution_clock::now();
+        double setInsertMs = std::chrono::duration<double, std::milli>(end - start).count();
+
+        std::cout << "  n=" << n << " inserts: B+-tree " << treeInsertMs << " ms, std::multiset " << setInsertMs
+                  << " ms";
+        if (n <= 100000) {
+            start = std::chrono::high_resolution_clock::now();
+            std::vector<int> sorted;
+            for (int key : keys) {
+                sorted.insert(std::upper_bound(sorted.begin(), sorted.end(), key), key);
+            }
+            end = std::chrono::high_resolution_clock::now();
+            std::cout << ", sorted vector " << std::chrono::duration<double, std::milli>(end - start).count()
+                      << " ms";
+        }
+        std::cout << std::endl;
+
+        std::shuffle(keys.begin(), keys.end(), rng);
+        long long treeChecksum = 0;
+        start = std::chrono::high_resolution_clock::now();
+        for (int key : keys) {
+            treeChecksum += *tree.lowerBound(key);
+        }
+        end = std::chrono::high_resolution_clock::now();
+        double treeLookupMs = std::chrono::duration<double, std::milli>(end - start).count();
+
+        long long setChecksum = 0;
+        start = std::chrono::high_resolution_clock::now();
+        for (int key : keys) {
+            setChecksum += *set.lower_bound(key);
+        }
+        end = std::chrono::high_resolution_clock::now();
+        double setLookupMs = std::chrono::duration<double, std::milli>(end - start).count();
+
+        std::cout << "  n=" << n << " lookups: B+-tree " << treeLookupMs << " ms, std::multiset " << setLookupMs
+                  << " ms" << (treeChecksum == setChecksum ? "" : "  MISMATCH") << std::endl;
+    }
 }
 
 /**
- * Template version for any comparable type.
+ * Benchmark: FrontCodedDictionary against binarySearchTemplate over a
+ * std::vector<std::string> of URL-like keys, for memory and lookups.
  */
-template<typename T>
-int binarySearchTemplate(const std::vector<T>& arr, const T& target) {
-    if (arr.empty()) {
-        return -1;
+void benchmarkFrontCodedDictionary() {
+    std::cout << "\n=== Benchmark: front-coded dictionary vs vector of strings ===" << std::endl;
+
+    std::mt19937 rng(42);
+    const size_t n = 2000000;
+    std::vector<std::string> urls(n);
+    for (std::string& url : urls) {
+        url = "https://www.example.com/catalog/item/" + std::to_string(rng() % 100000000) + "/details";
+    }
+    std::sort(urls.begin(), urls.end());
+    urls.erase(std::unique(urls.begin(), urls.end()), urls.end());
+
+    FrontCodedDictionary dictionary(urls);
+    size_t vectorBytes = urls.size() * sizeof(std::string);
+    for (const std::string& url : urls) {
+        vectorBytes += url.capacity() + 1;
     }
 
-    int left = 0;
-    int right = arr.size() - 1;
+    std::vector<std::string> queries(500000);
+    for (std::string& query : queries) {
+        query = rng() % 2 ? urls[rng() % urls.size()]
+                          : "https://www.example.com/catalog/item/" + std::to_string(rng() % 100000000) + "/details";
+    }
 
-    while (left <= right) {
-        int mid = left + (right - left) / 2;
+    long long vectorChecksum = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (const std::string& query : queries) {
+        vectorChecksum += binarySearchTemplate(urls, query);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    double vectorMs = std::chrono::duration<double, std::milli>(end - start).count();
 
-        if (arr[mid] == target) {
-            return mid;
-        } else if (arr[mid] < target) {
-            left = mid + 1;
-        } else {
-            right = mid - 1;
-        }
+    long long dictionaryChecksum = 0;
+    start = std::chrono::high_resolution_clock::now();
+    for (const std::string& query : queries) {
+        dictionaryChecksum += dictionary.find(query);
     }
+    end = std::chrono::high_resolution_clock::now();
+    double dictionaryMs = std::chrono::duration<double, std::milli>(end - start).count();
 
-    return -1;
+    std::cout << "  " << urls.size() << " URLs: vector " << vectorBytes / (1 << 20) << " MiB, " << vectorMs
+              << " ms; front-coded " << dictionary.bytes() / (1 << 20) << " MiB, " << dictionaryMs << " ms"
+              << (vectorChecksum == dictionaryChecksum ? "" : "  MISMATCH") << std::endl;
 }
 
-// Test function
-void printVector(const std::vector<int>& vec) {
-    std::cout << "[";
-    for (size_t i = 0; i < vec.size(); ++i) {
-        std::cout << vec[i];
-        if (i < vec.size() - 1) std::cout << ", ";
+/**
+ * Benchmark: binarySearch against FilteredSearchIndex over an array in
+ * DRAM, at several shares of lookups that miss.
+ */
+void benchmarkFilteredSearch() {
+    std::cout << "\n=== Benchmark: Bloom-filtered search by miss ratio ===" << std::endl;
+
+    const size_t n = 10000000;
+    const size_t queryCount = 2000000;
+    std::vector<int> sorted(n);
+    for (size_t i = 0; i < n; i++) {
+        sorted[i] = static_cast<int>(2 * i);  // Odd keys always miss
+    }
+    FilteredSearchIndex index(sorted, 0.01);
+    std::cout << "  n=" << n << ", filter " << index.filterBytes() / (1 << 20) << " MiB at 1% false positives"
+              << std::endl;
+
+    std::mt19937 rng(42);
+    for (double missRatio : {0.0, 0.5, 0.9, 0.99}) {
+        std::vector<int> queries(queryCount);
+        for (int& query : queries) {
+            query = static_cast<int>(2 * (rng() % n)) + (rng() % 1000 < missRatio * 1000 ? 1 : 0);
+        }
+
+        long long plainChecksum = 0;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int query : queries) {
+            plainChecksum += binarySearch(sorted, query);
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        double plainMs = std::chrono::duration<double, std::milli>(end - start).count();
+
+        index.resetCounters();
+        long long filteredChecksum = 0;
+        start = std::chrono::high_resolution_clock::now();
+        for (int query : queries) {
+            filteredChecksum += index.find(query);
+        }
+        end = std::chrono::high_resolution_clock::now();
+        double filteredMs = std::chrono::duration<double, std::milli>(end - start).count();
+
+        const FilterCounters& counters = index.counters();
+        std::cout << "  " << missRatio * 100 << "% misses: binarySearch " << plainMs << " ms, filtered "
+                  << filteredMs << " ms, speedup " << plainMs / filteredMs << "x (hits " << counters.hits
+                  << ", definite misses " << counters.definiteMisses << ", false positives "
+                  << counters.falsePositives << ")" << (plainChecksum == filteredChecksum ? "" : "  MISMATCH")
+                  << std::endl;
     }
-    std::cout << "]";
 }
 
-int main() {
+int main(int argc, char* argv[]) {
     std::cout << "=== Binary Search Examples ===" << std::endl;
 
     // Test cases
@@ -257,8 +4052,8 @@ int main() {
         printVector(testArrays[i]);
         std::cout << ", Target: " << targets[i] << std::endl;
 
-        int result = binarySearch(testArrays[i], targets[i]);
-        if (result != -1) {
+        std::ptrdiff_t result = binarySearch(testArrays[i], targets[i]);
+        if (result != notFound) {
             std::cout << "Found at index " << result << std::endl;
         } else {
             std::cout << "Not found" << std::endl;
@@ -268,9 +4063,9 @@ int main() {
     std::cout << "\n=== Recursive Binary Search ===" << std::endl;
     std::vector<int> arr = {1, 3, 5, 7, 9, 11, 13, 15, 17, 19};
     int target = 7;
-    int recursiveResult = binarySearchRecursive(arr, target);
+    std::ptrdiff_t recursiveResult = binarySearchRecursive(arr, target);
     std::cout << "Recursive search for " << target << ": ";
-    if (recursiveResult != -1) {
+    if (recursiveResult != notFound) {
         std::cout << "Found at index " << recursiveResult << std::endl;
     } else {
         std::cout << "Not found" << std::endl;
@@ -282,8 +4077,8 @@ int main() {
     std::cout << "\n=== Duplicate Handling ===" << std::endl;
     std::vector<int> arrWithDups = {1, 2, 2, 2, 2, 3, 4, 5};
     int dupTarget = 2;
-    int first = binarySearchFirstOccurrence(arrWithDups, dupTarget);
-    int last = binarySearchLastOccurrence(arrWithDups, dupTarget);
+    std::ptrdiff_t first = binarySearchFirstOccurrence(arrWithDups, dupTarget);
+    std::ptrdiff_t last = binarySearchLastOccurrence(arrWithDups, dupTarget);
 
     std::cout << "Array: ";
     printVector(arrWithDups);
@@ -295,7 +4090,7 @@ int main() {
     std::cout << "\n=== Template Example with Strings ===" << std::endl;
     std::vector<std::string> strings = {"apple", "banana", "cherry", "date", "elderberry"};
     std::string stringTarget = "cherry";
-    int stringResult = binarySearchTemplate(strings, stringTarget);
+    std::ptrdiff_t stringResult = binarySearchTemplate(strings, stringTarget);
 
     std::cout << "String array: [";
     for (size_t i = 0; i < strings.size(); ++i) {
@@ -304,11 +4099,43 @@ int main() {
     }
     std::cout << "]" << std::endl;
     std::cout << "Target: \"" << stringTarget << "\"" << std::endl;
-    if (stringResult != -1) {
+    if (stringResult != notFound) {
         std::cout << "Found at index " << stringResult << std::endl;
     } else {
         std::cout << "Not found" << std::endl;
     }
 
+    testEytzingerIndex();
+    testBranchlessBounds();
+    testSTreeIndex();
+    testBinarySearchBatch();
+    testPgmIndex();
+    testInterpolationSearch();
+    testGallopingSearch();
+    testSetOperations();
+    testBeyond4GElements();
+    testEqualRange();
+    testFractionalCascading();
+    testBPlusTree();
+    testFrontCodedDictionary();
+    testFilteredSearch();
+
+    // Benchmarks take noticeably longer, so they only run on request
+    if (argc > 1 && std::string(argv[1]) == "--benchmark") {
+        benchmarkEytzingerIndex();
+        benchmarkBranchlessBounds();
+        benchmarkSTreeIndex();
+        benchmarkBinarySearchBatch();
+        benchmarkPgmIndex();
+        benchmarkInterpolationSearch();
+        benchmarkGallopingSearch();
+        benchmarkSetIntersection();
+        benchmarkEqualRange();
+        benchmarkFractionalCascading();
+        benchmarkBPlusTree();
+        benchmarkFrontCodedDictionary();
+        benchmarkFilteredSearch();
+    }
+
     return 0;
 }
\ No newline at end of file
@@ -18,6 +18,41 @@ static void swap(int* a, int* b) {
     *b = temp;
 }
 
+/**
+ * Swap two non-overlapping blocks of memory
+ * 交换两块不重叠的内存
+ */
+static void swap_bytes(char* a, char* b, size_t size) {
+    for (size_t k = 0; k < size; k++) {
+        char temp = a[k];
+        a[k] = b[k];
+        b[k] = temp;
+    }
+}
+
+/**
+ * One branchless bubble pass over arr[0..bound]: each compare-exchange is
+ * a min/max select (compiled to conditional moves) and the larger value is
+ * carried to the next comparison in a register. Returns the index of the
+ * last exchange; everything after it is already in place.
+ * 无分支的一趟冒泡：比较交换用 min/max 选择实现，返回最后一次交换的位置
+ */
+static size_t bubble_pass_branchless(int* arr, size_t bound, bool descending) {
+    size_t last_exchange = 0;
+    int carry = arr[0];
+
+    for (size_t j = 0; j < bound; j++) {
+        int next = arr[j + 1];
+        bool exchange = descending ? next > carry : next < carry;
+        arr[j] = exchange ? next : carry;
+        carry = exchange ? carry : next;
+        last_exchange = exchange ? j : last_exchange;
+    }
+
+    arr[bound] = carry;
+    return last_exchange;
+}
+
 /**
  * Sort an integer array using bubble sort algorithm
  * 使用冒泡排序算法对整数数组进行排序
@@ -27,24 +62,10 @@ bool bubble_sort(int* arr, size_t length) {
         return true;  // Empty array is considered sorted
     }
 
-    // Traverse through all array elements
-    for (size_t i = 0; i < length; i++) {
-        // Flag to optimize by detecting if array is already sorted
-        bool swapped = false;
-
-        // Last i elements are already in place
-        for (size_t j = 0; j < length - i - 1; j++) {
-            // Swap if the element found is greater than the next element
-            if (arr[j] > arr[j + 1]) {
-                swap(&arr[j], &arr[j + 1]);
-                swapped = true;
-            }
-        }
-
-        // If no swapping happened, array is sorted
-        if (!swapped) {
-            break;
-        }
+    // Pairs (j, j + 1) with j < bound still need comparing; each pass
+    // shrinks the bound to its last exchange instead of by one
+    for (size_t bound = length - 1; bound > 0;) {
+        bound = bubble_pass_branchless(arr, bound, false);
     }
 
     return true;
@@ -59,20 +80,8 @@ bool bubble_sort_descending(int* arr, size_t length) {
         return true;  // Empty array is considered sorted
     }
 
-    for (size_t i = 0; i < length; i++) {
-        bool swapped = false;
-
-        for (size_t j = 0; j < length - i - 1; j++) {
-            // Change comparison for descending order
-            if (arr[j] < arr[j + 1]) {
-                swap(&arr[j], &arr[j + 1]);
-                swapped = true;
-            }
-        }
-
-        if (!swapped) {
-            break;
-        }
+    for (size_t bound = length - 1; bound > 0;) {
+        bound = bubble_pass_branchless(arr, bound, true);
     }
 
     return true;
@@ -136,12 +145,189 @@ bool bubble_sort_generic(void* base, size_t num_elements, size_t element_size,
             char* elem2 = arr + (j + 1) * element_size;
 
             if (compare(elem1, elem2) > 0) {
-                // Swap elements
-                for (size_t k = 0; k < element_size; k++) {
-                    char temp = elem1[k];
-                    elem1[k] = elem2[k];
-                    elem2[k] = temp;
-                }
+                swap_bytes(elem1, elem2, element_size);
+                swapped = true;
+            }
+        }
+
+        if (!swapped) {
+            break;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Bubble sort short blocks, then merge the blocks bottom-up
+ * 先对短块进行冒泡排序，再自底向上归并各块
+ */
+bool bubble_sort_blocked(void* base, size_t num_elements, size_t element_size,
+                         int (*compare)(const void*, const void*), void* scratch) {
+    if (num_elements <= 1) {
+        return true;
+    }
+    if (base == NULL || element_size == 0 || compare == NULL) {
+        return false;
+    }
+
+    char* data = (char*)base;
+    for (size_t start = 0; start < num_elements; start += BUBBLE_SORT_BLOCK) {
+        size_t length = num_elements - start < BUBBLE_SORT_BLOCK ? num_elements - start : BUBBLE_SORT_BLOCK;
+        bubble_sort_generic(data + start * element_size, length, element_size, compare);
+    }
+    if (num_elements <= BUBBLE_SORT_BLOCK) {
+        return true;
+    }
+
+    char* buffer = (char*)scratch;
+    if (buffer == NULL) {
+        buffer = (char*)malloc(num_elements * element_size);
+        if (buffer == NULL) {
+            return false;
+        }
+    }
+
+    // Each pass merges pairs of runs of the current width from src into dst
+    char* src = data;
+    char* dst = buffer;
+    for (size_t width = BUBBLE_SORT_BLOCK; width < num_elements; width *= 2) {
+        for (size_t start = 0; start < num_elements; start += 2 * width) {
+            size_t mid = num_elements - start < width ? num_elements : start + width;
+            size_t end = num_elements - mid < width ? num_elements : mid + width;
+            bubble_sort_merge(src + start * element_size, mid - start, src + mid * element_size, end - mid,
+                              element_size, compare, dst + start * element_size);
+        }
+        char* swap_runs = src;
+        src = dst;
+        dst = swap_runs;
+    }
+
+    if (src != data) {
+        memcpy(data, src, num_elements * element_size);
+    }
+    if (scratch == NULL) {
+        free(buffer);
+    }
+    return true;
+}
+
+/**
+ * Merge two sorted runs into out
+ * 将两个有序段归并到 out
+ */
+bool bubble_sort_merge(const void* first, size_t first_count, const void* second, size_t second_count,
+                       size_t element_size, int (*compare)(const void*, const void*), void* out) {
+    if (first_count + second_count == 0) {
+        return true;
+    }
+    if ((first == NULL && first_count > 0) || (second == NULL && second_count > 0)
+        || out == NULL || element_size == 0 || compare == NULL) {
+        return false;
+    }
+
+    const char* a = (const char*)first;
+    const char* a_end = a + first_count * element_size;
+    const char* b = (const char*)second;
+    const char* b_end = b + second_count * element_size;
+    char* dst = (char*)out;
+
+    while (a < a_end && b < b_end) {
+        // Take from the second run only when strictly smaller, keeping the merge stable
+        if (compare(b, a) < 0) {
+            memcpy(dst, b, element_size);
+            b += element_size;
+        } else {
+            memcpy(dst, a, element_size);
+            a += element_size;
+        }
+        dst += element_size;
+    }
+    if (a < a_end) {
+        memcpy(dst, a, (size_t)(a_end - a));
+        dst += a_end - a;
+    }
+    if (b < b_end) {
+        memcpy(dst, b, (size_t)(b_end - b));
+    }
+
+    return true;
+}
+
+/**
+ * Sort keys spaced stride bytes apart, moving only the keys
+ * 对按步长间隔排列的键进行排序，只移动键本身
+ */
+bool bubble_sort_strided(void* base, size_t count, size_t stride, size_t key_size,
+                         int (*compare)(const void*, const void*)) {
+    return bubble_sort_strided_records(base, count, stride, key_size, 0, compare);
+}
+
+/**
+ * Compute the sorted order of strided keys without moving anything
+ * 计算按步长间隔排列的键的排序顺序，不移动任何数据
+ */
+bool bubble_sort_strided_permutation(const void* base, size_t count, size_t stride,
+                                     int (*compare)(const void*, const void*),
+                                     size_t* permutation) {
+    if (count == 0) {
+        return true;
+    }
+    if (base == NULL || compare == NULL || permutation == NULL) {
+        return false;
+    }
+
+    const char* keys = (const char*)base;
+
+    for (size_t i = 0; i < count; i++) {
+        permutation[i] = i;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        bool swapped = false;
+
+        for (size_t j = 0; j < count - i - 1; j++) {
+            // Only the indices move; the keys are read in place
+            if (compare(keys + permutation[j] * stride, keys + permutation[j + 1] * stride) > 0) {
+                size_t temp = permutation[j];
+                permutation[j] = permutation[j + 1];
+                permutation[j + 1] = temp;
+                swapped = true;
+            }
+        }
+
+        if (!swapped) {
+            break;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Sort whole records spaced stride bytes apart by a key inside each record
+ * 按记录内的键对按步长间隔排列的整条记录进行排序
+ */
+bool bubble_sort_strided_records(void* base, size_t count, size_t stride, size_t record_size,
+                                 size_t key_offset, int (*compare)(const void*, const void*)) {
+    if (count <= 1) {
+        return true;
+    }
+    if (base == NULL || compare == NULL || record_size == 0 || stride < record_size) {
+        return false;
+    }
+
+    char* records = (char*)base;
+
+    for (size_t i = 0; i < count; i++) {
+        bool swapped = false;
+
+        for (size_t j = 0; j < count - i - 1; j++) {
+            char* rec1 = records + j * stride;
+            char* rec2 = rec1 + stride;
+
+            if (compare(rec1 + key_offset, rec2 + key_offset) > 0) {
+                swap_bytes(rec1, rec2, record_size);
                 swapped = true;
             }
         }
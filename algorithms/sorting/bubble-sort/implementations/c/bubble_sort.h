@@ -67,6 +67,98 @@ bool bubble_sort_with_result(int* arr, size_t length, BubbleSortResult* result);
 bool bubble_sort_generic(void* base, size_t num_elements, size_t element_size,
                         int (*compare)(const void*, const void*));
 
+/**
+ * Elements per block that bubble_sort_blocked bubble-sorts before merging
+ * bubble_sort_blocked 在归并前逐块冒泡排序的元素个数
+ */
+#define BUBBLE_SORT_BLOCK 32
+
+/**
+ * Bubble sort short blocks, then merge the blocks bottom-up
+ * 先对短块进行冒泡排序，再自底向上归并各块
+ *
+ * Bubble sort only ever sees BUBBLE_SORT_BLOCK elements at a time, where
+ * its quadratic cost stays small; stable merges combine the sorted blocks,
+ * so the whole sort is O(n log n) and stable.
+ *
+ * @param base Pointer to the array
+ * @param num_elements Number of elements
+ * @param element_size Size of each element in bytes
+ * @param compare Comparison function (should return <0, 0, or >0)
+ * @param scratch Buffer of num_elements * element_size bytes, or NULL to allocate one
+ * @return true on success, false on invalid arguments or allocation failure
+ */
+bool bubble_sort_blocked(void* base, size_t num_elements, size_t element_size,
+                         int (*compare)(const void*, const void*), void* scratch);
+
+/**
+ * Merge two sorted runs into out
+ * 将两个有序段归并到 out
+ *
+ * Equal elements are taken from the first run first, so the merge is
+ * stable. out must not overlap either run.
+ *
+ * @param first First sorted run
+ * @param first_count Number of elements in the first run
+ * @param second Second sorted run
+ * @param second_count Number of elements in the second run
+ * @param element_size Size of each element in bytes
+ * @param compare Comparison function (should return <0, 0, or >0)
+ * @param out Receives first_count + second_count elements
+ * @return true on success, false on invalid arguments
+ */
+bool bubble_sort_merge(const void* first, size_t first_count, const void* second, size_t second_count,
+                       size_t element_size, int (*compare)(const void*, const void*), void* out);
+
+/**
+ * Sort keys spaced stride bytes apart, moving only the keys
+ * 对按步长间隔排列的键进行排序，只移动键本身
+ *
+ * Sorts e.g. one column of a row-major matrix in place while the other
+ * columns stay put. Works directly on caller-owned memory (including
+ * mmap'd regions); nothing is copied.
+ *
+ * @param base Pointer to the first key
+ * @param count Number of keys
+ * @param stride Distance in bytes between consecutive keys (>= key_size)
+ * @param key_size Size of each key in bytes
+ * @param compare Comparison function (should return <0, 0, or >0)
+ * @return true on success, false on invalid arguments
+ */
+bool bubble_sort_strided(void* base, size_t count, size_t stride, size_t key_size,
+                         int (*compare)(const void*, const void*));
+
+/**
+ * Compute the sorted order of strided keys without moving anything
+ * 计算按步长间隔排列的键的排序顺序，不移动任何数据
+ *
+ * @param base Pointer to the first key
+ * @param count Number of keys
+ * @param stride Distance in bytes between consecutive keys
+ * @param compare Comparison function (should return <0, 0, or >0)
+ * @param permutation Output array of count indices; permutation[i] is the
+ *                    index of the i-th smallest key (ties keep input order)
+ * @return true on success, false on invalid arguments
+ */
+bool bubble_sort_strided_permutation(const void* base, size_t count, size_t stride,
+                                     int (*compare)(const void*, const void*),
+                                     size_t* permutation);
+
+/**
+ * Sort whole records spaced stride bytes apart by a key inside each record
+ * 按记录内的键对按步长间隔排列的整条记录进行排序
+ *
+ * @param base Pointer to the first record
+ * @param count Number of records
+ * @param stride Distance in bytes between consecutive records (>= record_size)
+ * @param record_size Number of bytes moved per record
+ * @param key_offset Offset of the key within each record
+ * @param compare Comparison function applied to the keys
+ * @return true on success, false on invalid arguments
+ */
+bool bubble_sort_strided_records(void* base, size_t count, size_t stride, size_t record_size,
+                                 size_t key_offset, int (*compare)(const void*, const void*));
+
 /**
  * Check if an array is sorted in ascending order
  * 检查数组是否按升序排序
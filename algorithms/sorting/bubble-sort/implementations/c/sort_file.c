@@ -0,0 +1,461 @@
+/**
+ * Sort a Binary Integer File In Place
+ * 原地排序二进制整数文件
+ *
+ * Memory-maps a raw file of native-endian int32 or int64 values and sorts
+ * it in place, so the data never passes through stdio buffers.
+ *
+ * Usage: bubble_sort_file [options] FILE
+ *   -t int32|int64     Element type (default int32)
+ *   -a bubble|merge    Algorithm (default merge)
+ *   -j N               Threads for the merge algorithm (default: all CPUs,
+ *                      at most SORT_FILE_THREADS_PER_CPU per CPU)
+ *   -o asc|desc        Sort order (default asc)
+ *   -c                 Verify the result after sorting
+ *   -q                 Do not print timings
+ *   -h                 Show help
+ *
+ * "bubble" runs plain bubble sort over the whole file and is only
+ * practical for small files. "merge" sorts one slice per thread with
+ * bubble_sort_blocked and then merges the slices pairwise in parallel with
+ * bubble_sort_merge, both through an anonymous scratch mapping.
+ */
+
+#define _GNU_SOURCE
+
+#include "bubble_sort.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+// Upper bound for -j relative to the online CPU count
+#define SORT_FILE_THREADS_PER_CPU 4
+
+typedef int (*CompareFn)(const void*, const void*);
+
+/**
+ * Options parsed from the command line
+ * 命令行选项
+ */
+typedef struct {
+    const char* path;
+    size_t element_size;    // 4 for int32, 8 for int64
+    bool use_bubble;        // bubble sort library instead of parallel merge
+    size_t threads;
+    bool descending;
+    bool verify;
+    bool quiet;
+    bool help;
+} SortFileOptions;
+
+/**
+ * Work item for one sorting or merging thread
+ * 单个排序或归并线程的工作项
+ */
+typedef struct {
+    const char* src;
+    char* dst;              // run to sort in place, or merge output
+    char* scratch;          // sort buffer as large as the run (unused when merging)
+    size_t first_length;    // elements in the first run
+    size_t second_length;   // elements in the second run (0 when sorting)
+    size_t element_size;
+    CompareFn compare;
+} SortFileTask;
+
+static int compare_int32_asc(const void* a, const void* b) {
+    int32_t x, y;
+    memcpy(&x, a, sizeof(x));
+    memcpy(&y, b, sizeof(y));
+    return (x > y) - (x < y);
+}
+
+static int compare_int32_desc(const void* a, const void* b) {
+    return compare_int32_asc(b, a);
+}
+
+static int compare_int64_asc(const void* a, const void* b) {
+    int64_t x, y;
+    memcpy(&x, a, sizeof(x));
+    memcpy(&y, b, sizeof(y));
+    return (x > y) - (x < y);
+}
+
+static int compare_int64_desc(const void* a, const void* b) {
+    return compare_int64_asc(b, a);
+}
+
+static double elapsed_ms(const struct timespec* start, const struct timespec* end) {
+    return (double)(end->tv_sec - start->tv_sec) * 1000.0 +
+           (double)(end->tv_nsec - start->tv_nsec) / 1e6;
+}
+
+static void print_usage(const char* program) {
+    printf("Usage: %s [options] FILE\n", program);
+    printf("Sort a raw binary file of native-endian integers in place.\n\n");
+    printf("  -t int32|int64     Element type (default int32)\n");
+    printf("  -a bubble|merge    Algorithm (default merge)\n");
+    printf("  -j N               Threads for the merge algorithm (default: all CPUs,\n");
+    printf("                     at most %d per CPU)\n", SORT_FILE_THREADS_PER_CPU);
+    printf("  -o asc|desc        Sort order (default asc)\n");
+    printf("  -c                 Verify the result after sorting\n");
+    printf("  -q                 Do not print timings\n");
+    printf("  -h                 Show this help message\n");
+}
+
+/**
+ * Sort one slice with bubble_sort_blocked (thread entry point)
+ * 使用bubble_sort_blocked排序一个分片（线程入口）
+ */
+static void* sort_slice(void* arg) {
+    SortFileTask* task = (SortFileTask*)arg;
+    bubble_sort_blocked(task->dst, task->first_length, task->element_size, task->compare, task->scratch);
+    return NULL;
+}
+
+/**
+ * Merge two adjacent sorted runs from src into dst (thread entry point)
+ * 将src中两个相邻的有序段归并到dst（线程入口）
+ */
+static void* merge_runs(void* arg) {
+    SortFileTask* task = (SortFileTask*)arg;
+    const char* second = task->src + task->first_length * task->element_size;
+    bubble_sort_merge(task->src, task->first_length, second, task->second_length,
+                      task->element_size, task->compare, task->dst);
+    return NULL;
+}
+
+/**
+ * Run fn over all tasks, one thread each. If a thread cannot be created
+ * the remaining tasks run on the calling thread instead.
+ * 为每个任务启动一个线程执行fn；无法创建线程时在当前线程执行剩余任务
+ */
+static void run_tasks(SortFileTask* tasks, pthread_t* handles, size_t n, void* (*fn)(void*)) {
+    size_t started = 0;
+    while (started < n && pthread_create(&handles[started], NULL, fn, &tasks[started]) == 0) {
+        started++;
+    }
+    for (size_t t = started; t < n; t++) {
+        fn(&tasks[t]);
+    }
+    for (size_t t = 0; t < started; t++) {
+        pthread_join(handles[t], NULL);
+    }
+}
+
+/**
+ * Map an anonymous scratch buffer, preferring explicit huge pages
+ * 映射匿名临时缓冲区，优先使用大页
+ *
+ * @param bytes Minimum size of the buffer
+ * @param mapped_bytes Receives the mapped length to pass to munmap
+ * @return The buffer, or MAP_FAILED
+ */
+static void* map_scratch(size_t bytes, size_t* mapped_bytes) {
+#ifdef MAP_HUGETLB
+    const size_t huge_page = 2 * 1024 * 1024;
+    size_t huge_bytes = (bytes + huge_page - 1) / huge_page * huge_page;
+    void* scratch = mmap(NULL, huge_bytes, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (scratch != MAP_FAILED) {
+        *mapped_bytes = huge_bytes;
+        return scratch;
+    }
+#endif
+    void* fallback = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+#ifdef MADV_HUGEPAGE
+    if (fallback != MAP_FAILED) {
+        madvise(fallback, bytes, MADV_HUGEPAGE);  // transparent huge pages if enabled
+    }
+#endif
+    *mapped_bytes = bytes;
+    return fallback;
+}
+
+/**
+ * Parallel merge sort of count elements at data, with 1 <= threads <= count
+ * 对data处的count个元素进行并行归并排序（1 <= threads <= count）
+ */
+static bool parallel_merge_sort(char* data, size_t count, size_t element_size,
+                                CompareFn compare, size_t threads) {
+    size_t bytes = count * element_size;
+    size_t scratch_bytes = 0;
+    char* scratch = (char*)map_scratch(bytes, &scratch_bytes);
+    pthread_t* handles = (pthread_t*)malloc(threads * sizeof(pthread_t));
+    SortFileTask* tasks = (SortFileTask*)malloc(threads * sizeof(SortFileTask));
+    size_t* run_starts = (size_t*)malloc((threads + 1) * sizeof(size_t));
+    if (scratch == MAP_FAILED || handles == NULL || tasks == NULL || run_starts == NULL) {
+        if (scratch != MAP_FAILED) {
+            munmap(scratch, scratch_bytes);
+        }
+        free(handles);
+        free(tasks);
+        free(run_starts);
+        return false;
+    }
+
+    // Phase 1: every thread sorts its own slice in place, using the
+    // matching slice of the scratch mapping as its merge buffer
+    for (size_t t = 0; t <= threads; t++) {
+        run_starts[t] = count * t / threads;
+    }
+    for (size_t t = 0; t < threads; t++) {
+        SortFileTask task = {NULL, data + run_starts[t] * element_size, scratch + run_starts[t] * element_size,
+                             run_starts[t + 1] - run_starts[t], 0, element_size, compare};
+        tasks[t] = task;
+    }
+    run_tasks(tasks, handles, threads, sort_slice);
+
+    // Phase 2: merge adjacent runs pairwise, one thread per pair
+    size_t runs = threads;
+    char* src = data;
+    char* dst = scratch;
+    while (runs > 1) {
+        size_t merged = 0;
+        for (size_t r = 0; r < runs; r += 2) {
+            size_t start = run_starts[r];
+            size_t mid = run_starts[r + 1];
+            size_t end = (r + 2 <= runs) ? run_starts[r + 2] : mid;
+            SortFileTask task = {src + start * element_size, dst + start * element_size, NULL,
+                                 mid - start, end - mid, element_size, compare};
+            tasks[merged] = task;
+            run_starts[merged++] = start;
+        }
+        run_tasks(tasks, handles, merged, merge_runs);
+        run_starts[merged] = count;
+        runs = merged;
+
+        char* swap = src;
+        src = dst;
+        dst = swap;
+    }
+
+    if (src != data) {
+        memcpy(data, src, bytes);
+    }
+    munmap(scratch, scratch_bytes);
+    free(handles);
+    free(tasks);
+    free(run_starts);
+    return true;
+}
+
+/**
+ * Check that count elements are ordered by compare
+ * 检查count个元素是否按compare有序
+ */
+static bool verify_sorted(const char* data, size_t count, size_t element_size, CompareFn compare) {
+    for (size_t i = 1; i < count; i++) {
+        if (compare(data + (i - 1) * element_size, data + i * element_size) > 0) {
+            fprintf(stderr, "Verification failed at element %zu\n", i);
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool parse_options(int argc, char* argv[], SortFileOptions* options) {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    size_t max_threads = (cpus > 0 ? (size_t)cpus : 1) * SORT_FILE_THREADS_PER_CPU;
+    options->path = NULL;
+    options->element_size = sizeof(int32_t);
+    options->use_bubble = false;
+    options->threads = cpus > 0 ? (size_t)cpus : 1;
+    options->descending = false;
+    options->verify = false;
+    options->quiet = false;
+    options->help = false;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "t:a:j:o:cqh")) != -1) {
+        switch (opt) {
+        case 't':
+            if (strcmp(optarg, "int32") == 0) {
+                options->element_size = sizeof(int32_t);
+            } else if (strcmp(optarg, "int64") == 0) {
+                options->element_size = sizeof(int64_t);
+            } else {
+                fprintf(stderr, "Unknown type: %s\n", optarg);
+                return false;
+            }
+            break;
+        case 'a':
+            if (strcmp(optarg, "bubble") == 0) {
+                options->use_bubble = true;
+            } else if (strcmp(optarg, "merge") == 0) {
+                options->use_bubble = false;
+            } else {
+                fprintf(stderr, "Unknown algorithm: %s\n", optarg);
+                return false;
+            }
+            break;
+        case 'j': {
+            char* end = NULL;
+            long threads = strtol(optarg, &end, 10);
+            if (end == optarg || *end != '\0' || threads < 1) {
+                fprintf(stderr, "Invalid thread count: %s\n", optarg);
+                return false;
+            }
+            options->threads = (size_t)threads;
+            if (options->threads > max_threads) {
+                options->threads = max_threads;
+            }
+            break;
+        }
+        case 'o':
+            if (strcmp(optarg, "asc") == 0) {
+                options->descending = false;
+            } else if (strcmp(optarg, "desc") == 0) {
+                options->descending = true;
+            } else {
+                fprintf(stderr, "Unknown order: %s\n", optarg);
+                return false;
+            }
+            break;
+        case 'c':
+            options->verify = true;
+            break;
+        case 'q':
+            options->quiet = true;
+            break;
+        case 'h':
+            options->help = true;
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    if (optind != argc - 1) {
+        return false;
+    }
+    options->path = argv[optind];
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    SortFileOptions options;
+    if (!parse_options(argc, argv, &options)) {
+        print_usage(argv[0]);
+        return 2;
+    }
+    if (options.help) {
+        print_usage(argv[0]);
+        return 0;
+    }
+
+    struct timespec t_start, t_mapped, t_sorted, t_synced;
+    clock_gettime(CLOCK_MONOTONIC, &t_start);
+
+    int fd = open(options.path, O_RDWR);
+    if (fd < 0) {
+        fprintf(stderr, "Cannot open %s: %s\n", options.path, strerror(errno));
+        return 1;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        fprintf(stderr, "Cannot stat %s: %s\n", options.path, strerror(errno));
+        close(fd);
+        return 1;
+    }
+
+    size_t bytes = (size_t)st.st_size;
+    if (bytes % options.element_size != 0) {
+        fprintf(stderr, "File size %zu is not a multiple of %zu bytes\n", bytes, options.element_size);
+        close(fd);
+        return 1;
+    }
+    size_t count = bytes / options.element_size;
+    if (count == 0) {
+        close(fd);
+        return 0;
+    }
+
+    int flags = MAP_SHARED;
+#ifdef MAP_POPULATE
+    flags |= MAP_POPULATE;  // fault the whole file in up front instead of during the sort
+#endif
+    char* data = (char*)mmap(NULL, bytes, PROT_READ | PROT_WRITE, flags, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        fprintf(stderr, "Cannot map %s: %s\n", options.path, strerror(errno));
+        return 1;
+    }
+    madvise(data, bytes, MADV_WILLNEED);
+#ifdef MADV_HUGEPAGE
+    madvise(data, bytes, MADV_HUGEPAGE);  // honoured only where file THP is supported
+#endif
+    clock_gettime(CLOCK_MONOTONIC, &t_mapped);
+
+    CompareFn compare;
+    if (options.element_size == sizeof(int32_t)) {
+        compare = options.descending ? compare_int32_desc : compare_int32_asc;
+    } else {
+        compare = options.descending ? compare_int64_desc : compare_int64_asc;
+    }
+
+    if (options.threads > count) {
+        options.threads = count;  // at least one element per slice
+    }
+
+    bool ok;
+    if (options.use_bubble) {
+        madvise(data, bytes, MADV_SEQUENTIAL);
+        if (options.element_size == sizeof(int) && sizeof(int) == sizeof(int32_t)) {
+            ok = options.descending ? bubble_sort_descending((int*)data, count)
+                                    : bubble_sort((int*)data, count);
+        } else {
+            ok = bubble_sort_generic(data, count, options.element_size, compare);
+        }
+    } else {
+        ok = parallel_merge_sort(data, count, options.element_size, compare, options.threads);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t_sorted);
+
+    if (ok && msync(data, bytes, MS_SYNC) != 0) {
+        fprintf(stderr, "Cannot sync %s: %s\n", options.path, strerror(errno));
+        ok = false;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t_synced);
+
+    if (!ok) {
+        fprintf(stderr, "Sorting failed\n");
+        munmap(data, bytes);
+        return 1;
+    }
+
+    int status = 0;
+    if (options.verify) {
+        if (verify_sorted(data, count, options.element_size, compare)) {
+            if (!options.quiet) {
+                printf("Verified:  %zu elements in order\n", count);
+            }
+        } else {
+            status = 1;
+        }
+    }
+
+    if (!options.quiet) {
+        printf("Elements:  %zu x int%zu (%.1f MiB)\n", count, options.element_size * 8,
+               (double)bytes / (1024.0 * 1024.0));
+        printf("Algorithm: %s", options.use_bubble ? "bubble" : "merge");
+        if (!options.use_bubble) {
+            printf(" (%zu threads)", options.threads);
+        }
+        printf(", %s\n", options.descending ? "descending" : "ascending");
+        printf("Map:       %.3f ms\n", elapsed_ms(&t_start, &t_mapped));
+        printf("Sort:      %.3f ms\n", elapsed_ms(&t_mapped, &t_sorted));
+        printf("Sync:      %.3f ms\n", elapsed_ms(&t_sorted, &t_synced));
+    }
+
+    munmap(data, bytes);
+    return status;
+}
@@ -8,6 +8,18 @@
 #include <stdlib.h>
 #include <string.h>
 
+// Test helper functions
+static int int_compare(const void* a, const void* b) {
+    int x = *(const int*)a;
+    int y = *(const int*)b;
+    return (x > y) - (x < y);
+}
+
+// Compares the first int of an {key, input position} pair only
+static int pair_key_compare(const void* a, const void* b) {
+    return int_compare(a, b);
+}
+
 // Test setup and teardown
 void setUp(void) {
     // Called before each test
@@ -139,6 +151,128 @@ void test_bubble_sort_generic(void) {
     TEST_ASSERT_TRUE(true);  // Placeholder - would need proper int comparison function
 }
 
+// Test the branchless kernels against qsort on random arrays with duplicates
+void test_bubble_sort_random(void) {
+    int arr[200];
+    int expected[200];
+    srand(35);
+
+    for (size_t len = 1; len <= 200; len += 13) {
+        for (size_t i = 0; i < len; i++) {
+            arr[i] = rand() % 41 - 20;
+            expected[i] = arr[i];
+        }
+        qsort(expected, len, sizeof(int), int_compare);
+
+        TEST_ASSERT_TRUE(bubble_sort(arr, len));
+        TEST_ASSERT_EQUAL_INT_ARRAY(expected, arr, len);
+
+        TEST_ASSERT_TRUE(bubble_sort_descending(arr, len));
+        TEST_ASSERT_TRUE(is_sorted_descending(arr, len));
+        TEST_ASSERT_EQUAL_INT(expected[0], arr[len - 1]);
+        TEST_ASSERT_EQUAL_INT(expected[len - 1], arr[0]);
+    }
+}
+
+// Test strided sorting of a matrix column, permutations and whole records
+void test_bubble_sort_strided(void) {
+    // 4x3 row-major matrix; sort column 1 only
+    int matrix[4][3] = {
+        {1, 40, 100},
+        {2, 10, 200},
+        {3, 30, 300},
+        {4, 20, 400}
+    };
+
+    TEST_ASSERT_TRUE(bubble_sort_strided(&matrix[0][1], 4, sizeof(matrix[0]), sizeof(int), int_compare));
+
+    int expected_column[] = {10, 20, 30, 40};
+    for (size_t i = 0; i < 4; i++) {
+        TEST_ASSERT_EQUAL(expected_column[i], matrix[i][1]);
+        TEST_ASSERT_EQUAL((int)i + 1, matrix[i][0]);        // other columns untouched
+        TEST_ASSERT_EQUAL(((int)i + 1) * 100, matrix[i][2]);
+    }
+
+    // Permutation leaves the data alone
+    int rows[4][3] = {
+        {1, 40, 100},
+        {2, 10, 200},
+        {3, 30, 300},
+        {4, 10, 400}
+    };
+    size_t permutation[4];
+    TEST_ASSERT_TRUE(bubble_sort_strided_permutation(&rows[0][1], 4, sizeof(rows[0]), int_compare, permutation));
+
+    size_t expected_permutation[] = {1, 3, 2, 0};  // ties keep input order
+    for (size_t i = 0; i < 4; i++) {
+        TEST_ASSERT_EQUAL(expected_permutation[i], permutation[i]);
+        TEST_ASSERT_EQUAL((int)i + 1, rows[i][0]);
+    }
+
+    // Whole-row moves keyed on column 1
+    TEST_ASSERT_TRUE(bubble_sort_strided_records(rows, 4, sizeof(rows[0]), sizeof(rows[0]),
+                                                 sizeof(int), int_compare));
+    int expected_rows[4][3] = {
+        {2, 10, 200},
+        {4, 10, 400},
+        {3, 30, 300},
+        {1, 40, 100}
+    };
+    TEST_ASSERT_EQUAL_MEMORY(expected_rows, rows, sizeof(rows));
+
+    // Invalid arguments
+    TEST_ASSERT_TRUE(bubble_sort_strided(NULL, 0, sizeof(int), sizeof(int), int_compare));
+    TEST_ASSERT_FALSE(bubble_sort_strided(matrix, 4, 2, sizeof(int), int_compare));
+    TEST_ASSERT_FALSE(bubble_sort_strided(matrix, 4, sizeof(matrix[0]), sizeof(int), NULL));
+    TEST_ASSERT_FALSE(bubble_sort_strided_permutation(matrix, 4, sizeof(matrix[0]), int_compare, NULL));
+}
+
+// Test blocked sorting against qsort across block boundaries, its stability
+// and the merge on its own
+void test_bubble_sort_blocked(void) {
+    static int arr[1000];
+    static int expected[1000];
+    static int scratch[1000];
+    srand(31);
+
+    for (size_t len = 0; len <= 1000; len += 37) {
+        for (size_t i = 0; i < len; i++) {
+            arr[i] = rand() % 101 - 50;
+            expected[i] = arr[i];
+        }
+        qsort(expected, len, sizeof(int), int_compare);
+
+        TEST_ASSERT_TRUE(bubble_sort_blocked(arr, len, sizeof(int), int_compare, len % 2 ? scratch : NULL));
+        if (len > 0) {
+            TEST_ASSERT_EQUAL_INT_ARRAY(expected, arr, len);
+        }
+    }
+
+    // Equal keys keep their input order
+    static int pairs[300][2];
+    for (int i = 0; i < 300; i++) {
+        pairs[i][0] = rand() % 7;
+        pairs[i][1] = i;
+    }
+    TEST_ASSERT_TRUE(bubble_sort_blocked(pairs, 300, sizeof(pairs[0]), pair_key_compare, NULL));
+    for (size_t i = 1; i < 300; i++) {
+        TEST_ASSERT_TRUE(pairs[i - 1][0] < pairs[i][0]
+                         || (pairs[i - 1][0] == pairs[i][0] && pairs[i - 1][1] < pairs[i][1]));
+    }
+
+    int first[] = {1, 3, 3, 8};
+    int second[] = {2, 3, 9};
+    int merged[7];
+    int expected_merged[] = {1, 2, 3, 3, 3, 8, 9};
+    TEST_ASSERT_TRUE(bubble_sort_merge(first, 4, second, 3, sizeof(int), int_compare, merged));
+    TEST_ASSERT_EQUAL_INT_ARRAY(expected_merged, merged, 7);
+    TEST_ASSERT_TRUE(bubble_sort_merge(first, 4, NULL, 0, sizeof(int), int_compare, merged));
+    TEST_ASSERT_EQUAL_INT_ARRAY(first, merged, 4);
+
+    TEST_ASSERT_FALSE(bubble_sort_blocked(arr, 10, sizeof(int), NULL, NULL));
+    TEST_ASSERT_FALSE(bubble_sort_merge(first, 4, second, 3, sizeof(int), int_compare, NULL));
+}
+
 // Test utility functions
 void test_utility_functions(void) {
     // Test is_sorted functions
@@ -190,7 +324,10 @@ int main(void) {
     RUN_TEST(test_bubble_sort_descending);
     RUN_TEST(test_bubble_sort_with_result);
     RUN_TEST(test_bubble_sort_edge_cases);
+    RUN_TEST(test_bubble_sort_random);
     RUN_TEST(test_bubble_sort_generic);
+    RUN_TEST(test_bubble_sort_strided);
+    RUN_TEST(test_bubble_sort_blocked);
     RUN_TEST(test_utility_functions);
     RUN_TEST(test_error_handling);
 